@@ -45,6 +45,9 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+/* Replaced by app/src/heap_tlsf.c when HEAP_TLSF_CONFIG_ENABLE is 1. */
+#if !defined( HEAP_TLSF_CONFIG_ENABLE ) || ( HEAP_TLSF_CONFIG_ENABLE == 0 )
+
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -490,3 +493,4 @@ size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY use
 	taskEXIT_CRITICAL();
 }
 
+#endif /* HEAP_TLSF_CONFIG_ENABLE */
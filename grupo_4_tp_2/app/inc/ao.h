@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : ao.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_AO_H_
+#define INC_AO_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+/********************** macros ***********************************************/
+
+/* Evento mas grande que puede transportar la cola de un objeto activo */
+#define AO_CONFIG_EVENT_SIZE_MAX        (48)
+
+/* idle_timeout_ms: la tarea no se destruye nunca */
+#define AO_IDLE_FOREVER                 (UINT32_MAX)
+
+/* 1: kernel cooperativo (QV): todos los objetos corren hasta completar en una
+ * sola tarea, elegidos por prioridad con un bitmap de listos. Cada objeto
+ * cuesta solo su cola; stack_size e idle_timeout_ms se ignoran
+ * 0: una tarea de FreeRTOS por objeto */
+#define AO_CONFIG_KERNEL_QV             (0)
+#define AO_CONFIG_QV_MAX_OBJECTS        (32)    // un bit por objeto
+#define AO_CONFIG_QV_TASK_STACK_SIZE    (256)
+#define AO_CONFIG_QV_TASK_PRIORITY      (tskIDLE_PRIORITY)
+
+/* Reserva estatica de cola y tarea para un objeto activo. La RAM por objeto
+ * queda fija en compilacion: queue_length * event_size + stack_size palabras
+ * + StaticQueue_t + StaticTask_t (en QV solo la cola) */
+#if (1 == AO_CONFIG_KERNEL_QV)
+#define AO_STORAGE(name, event_size, queue_length, stack_size)\
+    static uint8_t name##_queue_[(queue_length) * (event_size)] __attribute__((aligned(8)));\
+    static ao_storage_t name = {.queue_buffer = name##_queue_, .stack = NULL}
+#else
+#define AO_STORAGE(name, event_size, queue_length, stack_size)\
+    static uint8_t name##_queue_[(queue_length) * (event_size)] __attribute__((aligned(8)));\
+    static StackType_t name##_stack_[(stack_size)];\
+    static ao_storage_t name = {.queue_buffer = name##_queue_, .stack = name##_stack_}
+#endif
+
+/********************** typedef **********************************************/
+
+typedef struct ao_s ao_t;
+
+typedef struct
+{
+    void (*init)(ao_t* self);                       // opcional, en la tarea antes del primer evento
+    void (*dispatch)(ao_t* self, void* pevent);     // un evento (copia del item de la cola)
+    void (*destroy)(ao_t* self);                    // opcional, al eliminar la tarea por inactividad
+} ao_vtable_t;
+
+/* destroy corre con el scheduler suspendido (vTaskSuspendAll en ao_stop_),
+ * para que no entre un evento entre la consulta de la cola y su borrado: no
+ * puede bloquear ni llamar APIs que esperen (colas con timeout, vTaskDelay),
+ * solo liberar recursos y loguear */
+
+typedef struct
+{
+    StaticQueue_t queue;
+    StaticTask_t task;
+    uint8_t* queue_buffer;
+    StackType_t* stack;
+} ao_storage_t;
+
+typedef struct
+{
+    const char* name;
+    const ao_vtable_t* vtable;
+    size_t event_size;
+    UBaseType_t queue_length;
+    uint16_t stack_size;
+    UBaseType_t priority;           // en QV ordena los objetos; a igual prioridad gana el ultimo en ao_init
+    uint32_t idle_timeout_ms;       // sin eventos en ese tiempo se eliminan cola y tarea
+    ao_storage_t* storage;          // NULL: cola y tarea en el heap
+} ao_config_t;
+
+typedef struct
+{
+    uint32_t dispatched;
+    uint32_t send_failed;
+    uint32_t starts;
+    uint32_t cycles_last;
+    uint32_t cycles_max;
+    UBaseType_t queue_max_used;
+} ao_stats_t;
+
+struct ao_s
+{
+    const ao_config_t* config;
+    QueueHandle_t hqueue;
+    TaskHandle_t htask;
+#if (1 == AO_CONFIG_KERNEL_QV)
+    uint32_t qv_bit;
+#endif
+    ao_stats_t stats;
+};
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void ao_init(ao_t* self, const ao_config_t* config);
+bool ao_send(ao_t* self, const void* pevent);
+bool ao_is_running(const ao_t* self);
+void ao_get_stats(const ao_t* self, ao_stats_t* pstats);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_AO_H_ */
+/********************** end of file ******************************************/
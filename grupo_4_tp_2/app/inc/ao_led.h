@@ -52,15 +52,40 @@ extern "C" {
 #include "main.h"
 #include "cmsis_os.h"
 
+#include "ao.h"
+#include "latency.h"
+#include "ao_timer.h"
+#include "led_pwm.h"
+
 /********************** macros ***********************************************/
 
+// El bench del pipeline en el host lo redefine para comparar largos de cola
+#ifndef AO_LED_QUEUE_LENGTH
+#define AO_LED_QUEUE_LENGTH     (10)
+#endif
+
+// 1: los eventos se copian en la cola (sin pool ni callback de liberacion)
+// 0: la cola transporta punteros a mensajes del pool del emisor
+#define AO_LED_CONFIG_BY_VALUE  (0)
+
+/* Cada LED activo es una tarea propia en el heap (storage NULL): stack de
+ * AO_LED_TASK_STACK_SIZE palabras (512 bytes) + TCB + cola, unos 850 bytes.
+ * Con los tres LEDs vivos son ~2.5 KB de los 15360 de configTOTAL_HEAP_SIZE,
+ * que se piden y devuelven con cada ciclo de AO_LED_IDLE_TIMEOUT_MS y pueden
+ * fragmentar el heap. Con AO_STORAGE el costo queda fijo en compilacion */
+#define AO_LED_TASK_STACK_SIZE  (128)
+#define AO_LED_TASK_PRIORITY    (tskIDLE_PRIORITY)
+#define AO_LED_IDLE_TIMEOUT_MS  (10000)
+
 /********************** typedef **********************************************/
 
 typedef enum
 {
   AO_LED_MESSAGE_ON,
   AO_LED_MESSAGE_OFF,
-  AO_LED_MESSAGE_BLINK,
+  AO_LED_MESSAGE_BLINK,     // param.blink
+  AO_LED_MESSAGE_FADE,      // param.fade
+  AO_LED_MESSAGE_TOGGLE,    // evento de tiempo del parpadeo por software
   AO_LED_MESSAGE__N,
 } ao_led_action_t;
 
@@ -78,23 +103,63 @@ typedef struct
 {
     ao_led_cb_t callback;
     ao_led_action_t action;
+    void* payload;          // Datos grandes: el receptor los libera llamando a callback
+    latency_stamp_t stamp;  // sellos por salto desde el flanco del pulsador
+    union
+    {
+        struct
+        {
+            uint16_t period_ms;
+            uint16_t duty;      // encendido, en por mil del periodo
+        } blink;
+        struct
+        {
+            uint16_t level;     // brillo final, 0 a LED_PWM_LEVEL_MAX
+            uint16_t ms;
+        } fade;
+    } param;
 } ao_led_message_t;
 
 typedef struct {
+  ao_t ao;                // primer miembro: el dispatch recibe el handle como ao_t*
   ao_led_color color;
-  QueueHandle_t hqueue;
+#if (0 == LED_PWM_CONFIG_ENABLE)
+  ao_timer_t blink;       // un disparo por cada flanco del parpadeo
+  uint16_t on_ms;
+  uint16_t off_ms;
+  bool lit;
+  bool blinking;          // un TOGGLE encolado antes de ON/OFF/BLINK se descarta
+  ao_led_message_t toggle_msg;
+#if (0 == AO_LED_CONFIG_BY_VALUE)
+  ao_led_message_t* ptoggle_msg;
+#endif
+#endif
 } ao_led_handle_t;
 
 /********************** external data declaration ****************************/
 extern const char * const led_color_name[];
 extern const char * const led_action_name[];
+extern ao_led_handle_t hao_led[AO_LED_COLOR__N];
 
 /********************** external functions declaration ***********************/
 
-void process_ao_led   (ao_led_handle_t* hao);
-void queue_led_delete (ao_led_handle_t* hao);
+void ao_led_init      (void);
 bool ao_led_send_event(ao_led_handle_t* hao, ao_led_message_t* pmsg);
 
+static inline void ao_led_message_blink(ao_led_message_t* pmsg, uint16_t period_ms, uint16_t duty)
+{
+    pmsg->action = AO_LED_MESSAGE_BLINK;
+    pmsg->param.blink.period_ms = period_ms;
+    pmsg->param.blink.duty = duty;
+}
+
+static inline void ao_led_message_fade(ao_led_message_t* pmsg, uint16_t level, uint16_t ms)
+{
+    pmsg->action = AO_LED_MESSAGE_FADE;
+    pmsg->param.fade.level = level;
+    pmsg->param.fade.ms = ms;
+}
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
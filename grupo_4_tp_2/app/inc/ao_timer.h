@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : ao_timer.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_AO_TIMER_H_
+#define INC_AO_TIMER_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+#include "ao.h"
+#include "time_wheel.h"
+
+/********************** macros ***********************************************/
+
+/* La tarea del servicio debe ganarle a los objetos activos para entregar los
+ * vencimientos a tiempo */
+#define AO_TIMER_CONFIG_TASK_STACK_SIZE     (256)
+#define AO_TIMER_CONFIG_TASK_PRIORITY       (tskIDLE_PRIORITY + 2)
+
+/********************** typedef **********************************************/
+
+/* Evento de tiempo: al vencer se envia pevent a la cola del objeto, como
+ * cualquier otro evento (lo que ao_send copia: el mensaje o su puntero) */
+typedef struct
+{
+    time_wheel_timer_t timer;       // primer miembro: el callback recibe el timer
+    ao_t* ao;
+    const void* pevent;
+    uint32_t posted;
+    uint32_t dropped;               // cola llena al vencer
+} ao_timer_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void ao_timer_service_init(void);
+void ao_timer_init(ao_timer_t* self, ao_t* ao, const void* pevent);
+bool ao_timer_arm(ao_timer_t* self, uint32_t delay_ms, uint32_t period_ms);
+bool ao_timer_cancel(ao_timer_t* self);
+bool ao_timer_is_armed(const ao_timer_t* self);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_AO_TIMER_H_ */
+/********************** end of file ******************************************/
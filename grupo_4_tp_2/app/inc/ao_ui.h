@@ -52,8 +52,24 @@ extern "C" {
 #include "main.h"
 #include "cmsis_os.h"
 
+#include "ao.h"
+#include "latency.h"
+
 /********************** macros ***********************************************/
 
+// El bench del pipeline en el host lo redefine para comparar largos de cola
+#ifndef AO_UI_QUEUE_LENGTH
+#define AO_UI_QUEUE_LENGTH      (5)
+#endif
+
+// 1: los eventos se copian en la cola (sin pool ni callback de liberacion)
+// 0: la cola transporta punteros a mensajes del pool del emisor
+#define AO_UI_CONFIG_BY_VALUE   (0)
+
+#define AO_UI_TASK_STACK_SIZE   (128)
+#define AO_UI_TASK_PRIORITY     (tskIDLE_PRIORITY)
+#define AO_UI_IDLE_TIMEOUT_MS   (10000)     // sin eventos se eliminan cola y tarea
+
 /********************** typedef **********************************************/
 
 typedef enum
@@ -71,15 +87,24 @@ typedef struct
 {
     ao_ui_cb_t callback;
     ao_ui_action_t action;
+    void* payload;          // Datos grandes: el receptor los libera llamando a callback
+    latency_stamp_t stamp;  // sellos por salto desde el flanco del pulsador
 } ao_ui_message_t;
 
+typedef struct
+{
+    ao_stats_t ao;
+    uint32_t led_pool_exhausted;    // eventos a los LED perdidos por falta de mensajes
+} ao_ui_stats_t;
+
 /********************** external data declaration ****************************/
 extern const char * const button_action_name[];
 
 /********************** external functions declaration ***********************/
 
-void task_ui(void* argument);
+void ao_ui_init(void);
 bool ao_ui_send_event(ao_ui_message_t *pmsg);
+void ao_ui_get_stats(ao_ui_stats_t* pstats);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
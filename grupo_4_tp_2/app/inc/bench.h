@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : bench.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_BENCH_H_
+#define INC_BENCH_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Benchmarks en el target: app_init crea task_bench, que corre todos una vez,
+ * reporta por el logger y se elimina. En el host, host/build/rtos_bench llama
+ * a bench_run() y termina */
+#define BENCH_CONFIG_ENABLE                     (0)
+#define BENCH_CONFIG_ITERATIONS                 (200)
+#define BENCH_CONFIG_TASK_PRIORITY              (tskIDLE_PRIORITY + 1)
+#define BENCH_CONFIG_TASK_STACK_SIZE            (256)
+#define BENCH_CONFIG_REPORT_DELAY_MS            (50)    // deja drenar al logger
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+    const char* name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t failed;        // iteraciones sin muestra: sin memoria o cola llena
+} bench_stats_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void task_bench(void* argument);
+void bench_run(void);
+void bench_rtos(void);
+
+void bench_stats_reset(bench_stats_t* pstats, const char* name);
+void bench_stats_add(bench_stats_t* pstats, uint32_t cycles);
+void bench_stats_fail(bench_stats_t* pstats);
+void bench_stats_report(const bench_stats_t* pstats);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_BENCH_H_ */
+/********************** end of file ******************************************/
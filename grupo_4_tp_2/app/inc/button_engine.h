@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : button_engine.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_BUTTON_ENGINE_H_
+#define INC_BUTTON_ENGINE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Clasificacion por duracion de la pulsacion */
+#define BUTTON_ENGINE_PULSE_MS          (200)
+#define BUTTON_ENGINE_SHORT_MS          (1000)
+#define BUTTON_ENGINE_LONG_MS           (2000)
+
+/* Un nivel se acepta cuando se mantiene estable este tiempo */
+#define BUTTON_ENGINE_DEBOUNCE_MS       (20)
+
+/********************** typedef **********************************************/
+
+typedef enum
+{
+	BUTTON_TYPE_NONE,
+	BUTTON_TYPE_PULSE,
+	BUTTON_TYPE_SHORT,
+	BUTTON_TYPE_LONG,
+	BUTTON_TYPE__N,
+} button_type_t;
+
+/* Motor de flancos sin dependencias de HAL ni RTOS: los tiempos son ticks de
+ * un contador libre de 32 bits (se admite el desborde) */
+typedef struct
+{
+	uint32_t ticks_per_ms;
+	uint32_t debounce_ticks;
+	bool pressed;               // estado filtrado
+	bool raw_pressed;           // nivel del ultimo flanco
+	uint32_t raw_time;          // instante del ultimo flanco
+	uint32_t press_time;        // instante aceptado de la pulsacion
+	uint32_t release_time;      // instante aceptado de la ultima liberacion
+	uint32_t edges;
+	uint32_t bounces;           // flancos descartados por el antirrebote
+} button_engine_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void button_engine_init(button_engine_t* pengine, uint32_t ticks_per_ms, uint32_t debounce_ms, bool pressed);
+void button_engine_edge(button_engine_t* pengine, uint32_t time, bool pressed);
+button_type_t button_engine_poll(button_engine_t* pengine, uint32_t now);
+bool button_engine_pending(const button_engine_t* pengine);
+button_type_t button_engine_classify(uint32_t duration_ms);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_BUTTON_ENGINE_H_ */
+/********************** end of file ******************************************/
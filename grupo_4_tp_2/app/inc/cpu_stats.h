@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : cpu_stats.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_CPU_STATS_H_
+#define INC_CPU_STATS_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+/********************** macros ***********************************************/
+
+/* Carga de CPU por tarea con el contador de run-time de FreeRTOS (timebase,
+ * us). Se mide por ventanas: el periodo debe ser menor al desborde de TIM2 */
+#define CPU_STATS_CONFIG_ENABLE                 (1)
+#define CPU_STATS_CONFIG_MAX_TASKS              (16)    // como MEM_STATS_CONFIG_MAX_TASKS
+#define CPU_STATS_CONFIG_REPORT_PERIOD_MS       (5000)
+#define CPU_STATS_CONFIG_TASK_PRIORITY          (tskIDLE_PRIORITY + 1)
+#define CPU_STATS_CONFIG_TASK_STACK_SIZE        (256)
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t number;
+    uint32_t run_us;            // tiempo ejecutado en la ventana
+    uint32_t load_x100;         // centesimas de %
+} cpu_stats_task_t;
+
+typedef struct
+{
+    uint32_t window_us;
+    uint32_t idle_x100;
+    uint32_t count;
+    cpu_stats_task_t task[CPU_STATS_CONFIG_MAX_TASKS];
+} cpu_stats_snapshot_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void cpu_stats_init(void);
+bool cpu_stats_snapshot(cpu_stats_snapshot_t* psnapshot);
+void cpu_stats_report(const cpu_stats_snapshot_t* psnapshot);
+void task_cpu_stats(void* argument);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_CPU_STATS_H_ */
+/********************** end of file ******************************************/
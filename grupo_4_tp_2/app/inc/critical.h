@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : critical.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_CRITICAL_H_
+#define INC_CRITICAL_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "dwt.h"
+
+/********************** macros ***********************************************/
+
+/* Secciones criticas instrumentadas: tiempo con las IRQ enmascaradas (hasta
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY) por punto de llamada, en ciclos del
+ * DWT. Las secciones anidadas se cargan al punto mas externo. Deshabilitado,
+ * cada macro es la de FreeRTOS */
+#define CRITICAL_CONFIG_ENABLE                  (1)
+#define CRITICAL_CONFIG_HISTOGRAM_BINS          (16)    // bin k: [2^(k-1), 2^k) ciclos
+#define CRITICAL_CONFIG_BUDGET_CYCLES           (840)   // 10 us a 84 MHz
+#define CRITICAL_CONFIG_BUDGET_ASSERT           (0)     // 1: configASSERT, 0: se cuenta y se informa
+#define CRITICAL_CONFIG_REPORT_TOP              (5)     // peores puntos en el reporte
+
+#if 1 == CRITICAL_CONFIG_ENABLE
+#define CRITICAL_ENTER(site)                    do { taskENTER_CRITICAL(); critical_enter_(site); } while (0)
+#define CRITICAL_EXIT()                         do { critical_exit_(); taskEXIT_CRITICAL(); } while (0)
+#define CRITICAL_ENTER_FROM_ISR(site)           critical_enter_from_isr_(site)
+#define CRITICAL_EXIT_FROM_ISR(mask)            do { critical_exit_(); taskEXIT_CRITICAL_FROM_ISR(mask); } while (0)
+#else
+#define CRITICAL_ENTER(site)                    taskENTER_CRITICAL()
+#define CRITICAL_EXIT()                         taskEXIT_CRITICAL()
+#define CRITICAL_ENTER_FROM_ISR(site)           taskENTER_CRITICAL_FROM_ISR()
+#define CRITICAL_EXIT_FROM_ISR(mask)            taskEXIT_CRITICAL_FROM_ISR(mask)
+#endif
+
+/********************** typedef **********************************************/
+
+typedef enum
+{
+    CRITICAL_SITE_LOGGER_LOG,           // LOGGER_LOG: snprintf + transporte
+    CRITICAL_SITE_LOGGER_RECORD,        // modo inmediato: formato + transporte
+    CRITICAL_SITE_LOGGER_UART,          // encolado en el doble buffer
+    CRITICAL_SITE_LOGGER_UART_ISR,      // fin de DMA, cambio de buffer
+    CRITICAL_SITE_AO_SEND,              // QV: cola + bit de listo
+    CRITICAL_SITE_AO_QV_READY,          // QV: limpieza del bit de listo
+    CRITICAL_SITE_BUTTON_ISR,           // flanco al motor de antirrebote
+    CRITICAL_SITE_BUTTON_POLL,          // clasificacion del motor
+    CRITICAL_SITE_MEMORY_POOL_GET,
+    CRITICAL_SITE_MEMORY_POOL_PUT,
+    CRITICAL_SITE_LED_PWM_SET,
+    CRITICAL_SITE_LED_PWM_BLINK,
+    CRITICAL_SITE_LED_PWM_FADE,
+    CRITICAL_SITE_LATENCY_RECORD,
+    CRITICAL_SITE_LATENCY_GET,          // copia de la ventana
+    CRITICAL_SITE_HEAP,                 // heap_tlsf con HEAP_TLSF_CONFIG_ISR_SAFE
+    CRITICAL_SITE__N,
+} critical_site_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t over_budget;
+    uint32_t histogram[CRITICAL_CONFIG_HISTOGRAM_BINS];
+} critical_stats_t;
+
+/********************** external data declaration ****************************/
+
+extern const char* const critical_site_name[];
+
+/* Estado de la seccion en curso; solo se tocan con las IRQ enmascaradas */
+extern uint32_t critical_depth_;
+extern uint32_t critical_t0_;
+extern critical_site_t critical_site_;
+
+/********************** external functions declaration ***********************/
+
+void critical_init(void);
+void critical_record_(critical_site_t site, uint32_t cycles);
+bool critical_get(critical_site_t site, critical_stats_t* pstats);
+void critical_reset(void);
+void critical_report(void);
+
+static inline void critical_enter_(critical_site_t site)
+{
+    if (0 == critical_depth_++)
+    {
+        critical_site_ = site;
+        critical_t0_ = cycle_counter_get();
+    }
+}
+
+static inline void critical_exit_(void)
+{
+    if (0 == --critical_depth_)
+    {
+        critical_record_(critical_site_, cycle_counter_elapsed(critical_t0_));
+    }
+}
+
+static inline UBaseType_t critical_enter_from_isr_(critical_site_t site)
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    critical_enter_(site);
+    return mask;
+}
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_CRITICAL_H_ */
+/********************** end of file ******************************************/
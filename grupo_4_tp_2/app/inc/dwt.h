@@ -69,11 +69,16 @@ extern "C" {
 
 /* disable counting if not used any more */
 /*!< CYCCNTENA bit in DWT_CONTROL register */
-#define cycle_counter_disable() (~DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk)
+#define cycle_counter_disable() (DWT->CTRL &= ~DWT_CTRL_CYCCNTENA_Msk)
 
 /* read cycle counter */
 /*!< DWT Cycle Counter register */
 #define cycle_counter_get() (DWT->CYCCNT)
+
+/* cycles since a previous cycle_counter_get(); the unsigned subtraction
+ * survives one CYCCNT wrap (intervals up to 2^32 cycles, ~51 s @ 84 MHz) */
+#define cycle_counter_elapsed(start) ((uint32_t)(DWT->CYCCNT - (uint32_t)(start)))
+
 #define cycles_per_us (SystemCoreClock / 1000000)
 #define cycle_counter_time_us() (DWT->CYCCNT / cycles_per_us)
 
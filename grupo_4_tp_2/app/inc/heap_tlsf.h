@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : heap_tlsf.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_HEAP_TLSF_H_
+#define INC_HEAP_TLSF_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+/* Se incluye desde FreeRTOSConfig.h (apaga heap_4.c): no depende de headers
+ * de FreeRTOS */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "tlsf.h"
+
+/********************** macros ***********************************************/
+
+/* pvPortMalloc/vPortFree sobre TLSF (app/src/tlsf.c) en lugar de heap_4: el
+ * mismo heap de configTOTAL_HEAP_SIZE, con malloc y free de tiempo acotado.
+ * El build de host lo elige con 'make HEAP=tlsf' */
+#ifndef HEAP_TLSF_CONFIG_ENABLE
+#define HEAP_TLSF_CONFIG_ENABLE         (0)
+#endif
+
+/* 0: se serializa con vTaskSuspendAll, como heap_4.
+ * 1: seccion critica (acotada por TLSF) y se habilitan las variantes FromISR */
+#define HEAP_TLSF_CONFIG_ISR_SAFE       (0)
+
+/********************** typedef **********************************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+#if (1 == HEAP_TLSF_CONFIG_ENABLE)
+
+void heap_tlsf_get_stats(tlsf_stats_t* pstats);
+
+#if (1 == HEAP_TLSF_CONFIG_ISR_SAFE)
+void* heap_tlsf_malloc_from_isr(size_t size);
+void heap_tlsf_free_from_isr(void* ptr);
+#endif
+
+#endif
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_HEAP_TLSF_H_ */
+/********************** end of file ******************************************/
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : latency.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_LATENCY_H_
+#define INC_LATENCY_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "timebase.h"
+
+/********************** macros ***********************************************/
+
+/* Latencia de punta a punta flanco del pulsador -> escritura del LED. Cada
+ * evento lleva un sello del timebase (us) por salto; ao_led registra las etapas al escribir
+ * el pin. Los percentiles salen de las ultimas LATENCY_CONFIG_WINDOW muestras */
+#define LATENCY_CONFIG_ENABLE                   (1)
+#define LATENCY_CONFIG_WINDOW                   (64)
+
+/********************** typedef **********************************************/
+
+typedef enum
+{
+    LATENCY_HOP_EDGE,                   // flanco aceptado, estampado en la EXTI
+    LATENCY_HOP_DETECT,                 // task_button clasifica y envia a ao_ui
+    LATENCY_HOP_UI_DISPATCH,            // ao_ui toma el evento
+    LATENCY_HOP_LED_SEND,               // ao_ui envia a ao_led
+    LATENCY_HOP_LED_DISPATCH,           // ao_led toma el evento
+    LATENCY_HOP_GPIO,                   // salida del LED (CCR1 del PWM o GPIO)
+    LATENCY_HOP__N,
+} latency_hop_t;
+
+/* La etapa i va del salto i al i + 1; TOTAL va de EDGE a GPIO */
+typedef enum
+{
+    LATENCY_STAGE_DEBOUNCE,             // antirrebote + despertar task_button
+    LATENCY_STAGE_UI_QUEUE,
+    LATENCY_STAGE_UI_PROCESS,
+    LATENCY_STAGE_LED_QUEUE,
+    LATENCY_STAGE_LED_PROCESS,
+    LATENCY_STAGE_TOTAL,
+    LATENCY_STAGE__N,
+} latency_stage_t;
+
+typedef struct
+{
+    uint32_t hops;                      // bit i: time[i] es valido
+    uint32_t time[LATENCY_HOP__N];      // timebase_us32()
+} latency_stamp_t;
+
+typedef struct
+{
+    uint32_t count;                     // muestras desde latency_reset()
+    uint32_t samples;                   // muestras en la ventana
+    uint32_t p50;                       // us, sobre la ventana
+    uint32_t p99;
+    uint32_t max;
+    uint32_t max_all;                   // maximo desde latency_reset()
+} latency_stats_t;
+
+/********************** external data declaration ****************************/
+
+extern const char* const latency_stage_name[];
+
+/********************** external functions declaration ***********************/
+
+static inline void latency_stamp_clear(latency_stamp_t* pstamp)
+{
+    pstamp->hops = 0;
+}
+
+static inline void latency_stamp_at(latency_stamp_t* pstamp, latency_hop_t hop, uint32_t time)
+{
+#if 1 == LATENCY_CONFIG_ENABLE
+    pstamp->time[hop] = time;
+    pstamp->hops |= (1UL << hop);
+#endif
+}
+
+static inline void latency_stamp(latency_stamp_t* pstamp, latency_hop_t hop)
+{
+    latency_stamp_at(pstamp, hop, timebase_us32());
+}
+
+void latency_init(void);
+void latency_record(const latency_stamp_t* pstamp);
+bool latency_get(latency_stage_t stage, latency_stats_t* pstats);
+void latency_reset(void);
+void latency_report(void);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_LATENCY_H_ */
+/********************** end of file ******************************************/
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : led_pwm.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_LED_PWM_H_
+#define INC_LED_PWM_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+
+/********************** macros ***********************************************/
+
+/* 1: el LED sale por TIM8_CH1N (LD2, PA5) y el parpadeo y los fundidos los
+ * genera el timer; la CPU solo escribe al cambiar de patron
+ * 0: los LED son GPIO y ao_led parpadea por software con ao_timer */
+#define LED_PWM_CONFIG_ENABLE           (1)
+
+/* Brillo en por mil, con correccion gamma cuadratica */
+#define LED_PWM_LEVEL_MAX               (1000)
+
+/* Entradas de la tabla que el DMA copia a CCR1 en cada fundido */
+#define LED_PWM_CONFIG_FADE_STEPS       (64)
+
+#define LED_PWM_TIM                     (TIM8)
+#define LED_PWM_TIM_CLOCK_HZ            (84000000UL)    // APB2, sin divisor
+
+/* Brillo fijo y fundidos: portadora de 1 kHz contando a 1 MHz */
+#define LED_PWM_DIM_COUNT_HZ            (1000000UL)
+#define LED_PWM_DIM_COUNTS              (1000)
+
+/* Parpadeo: el periodo del timer es el del parpadeo, contando a 10 kHz */
+#define LED_PWM_BLINK_COUNT_HZ          (10000UL)
+#define LED_PWM_BLINK_PERIOD_MAX_MS     (0x10000UL * 1000 / LED_PWM_BLINK_COUNT_HZ - 1)
+
+/* Cada paso del fundido dura a lo sumo 256 periodos (contador de repeticion) */
+#define LED_PWM_FADE_MAX_MS             (LED_PWM_CONFIG_FADE_STEPS * 256 * 1000 / (LED_PWM_DIM_COUNT_HZ / LED_PWM_DIM_COUNTS))
+
+/********************** typedef **********************************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void led_pwm_init(void);
+void led_pwm_set(uint16_t level);
+bool led_pwm_blink(uint16_t period_ms, uint16_t duty);
+bool led_pwm_fade(uint16_t level, uint32_t ms);
+uint16_t led_pwm_level(void);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_LED_PWM_H_ */
+/********************** end of file ******************************************/
@@ -49,39 +49,209 @@ extern "C" {
 #include <stdbool.h>
 #include <string.h>
 
+#include "critical.h"
+
 /********************** macros ***********************************************/
 
 #define LOGGER_CONFIG_ENABLE                    (1)
-#define LOGGER_CONFIG_MAXLEN                    (64)
+#define LOGGER_CONFIG_MAXLEN                    (64)    // largo de una linea completa
 #define LOGGER_CONFIG_USE_SEMIHOSTING           (1)
+#define LOGGER_CONFIG_USE_UART_DMA              (0)     // huart2, doble buffer
+#define LOGGER_CONFIG_UART_BUFFER_SIZE          (256)   // por cada uno de los 2 buffers
+#define LOGGER_CONFIG_USE_TIMESTAMP             (0)     // antepone "[us] " (timebase)
+#define LOGGER_CONFIG_TRUNCATION_MARK           "..."
+
+/* Niveles y modulos. Cada .c elige su modulo con "#define LOGGER_MODULE LED"
+ * y loguea con LOGGER_ERROR/WARN/INFO/DEBUG/TRACE; para otro modulo se usan
+ * las variantes _M, p.ej. LOGGER_DEBUG_M(MEMORY, ...). Una llamada por encima
+ * del umbral de su modulo no genera codigo ni evalua sus argumentos. */
+#define LOGGER_LEVEL_NONE                       (0)
+#define LOGGER_LEVEL_ERROR                      (1)
+#define LOGGER_LEVEL_WARN                       (2)
+#define LOGGER_LEVEL_INFO                       (3)
+#define LOGGER_LEVEL_DEBUG                      (4)
+#define LOGGER_LEVEL_TRACE                      (5)
+
+#define LOGGER_MODULE_APP                       (0)
+#define LOGGER_MODULE_BUTTON                    (1)
+#define LOGGER_MODULE_UI                        (2)
+#define LOGGER_MODULE_LED                       (3)
+#define LOGGER_MODULE_MEMORY                    (4)
+#define LOGGER_MODULE__N                        (5)
+
+#ifdef DEBUG
+#define LOGGER_CONFIG_LEVEL_DEFAULT             (LOGGER_LEVEL_DEBUG)
+#else
+#define LOGGER_CONFIG_LEVEL_DEFAULT             (LOGGER_LEVEL_INFO)
+#endif
+#define LOGGER_CONFIG_LEVEL_APP                 (LOGGER_CONFIG_LEVEL_DEFAULT)
+#define LOGGER_CONFIG_LEVEL_BUTTON              (LOGGER_CONFIG_LEVEL_DEFAULT)
+#define LOGGER_CONFIG_LEVEL_UI                  (LOGGER_CONFIG_LEVEL_DEFAULT)
+#define LOGGER_CONFIG_LEVEL_LED                 (LOGGER_CONFIG_LEVEL_DEFAULT)
+#define LOGGER_CONFIG_LEVEL_MEMORY              (LOGGER_CONFIG_LEVEL_DEFAULT)
+
+/* Modo diferido: LOGGER_INFO solo encola un registro (formato + argumentos) en
+ * un buffer circular lock-free; la tarea del logger formatea e imprime. */
+#define LOGGER_CONFIG_USE_DEFERRED              (1)
+#define LOGGER_CONFIG_DEFERRED_CAPACITY         (32)    // potencia de 2
+#define LOGGER_CONFIG_DEFERRED_MAX_ARGS         (4)     // fijo, ver LOGGER_NARGS_CHECK_
+#define LOGGER_CONFIG_TASK_PRIORITY             (tskIDLE_PRIORITY)
+#define LOGGER_CONFIG_TASK_STACK_SIZE           (256)
+#define LOGGER_CONFIG_TASK_PERIOD_MS            (100)
+
+/* Modo binario (requiere el modo diferido): los formatos van a la seccion
+ * .logger_fmt, que no ocupa flash, y por el transporte solo viajan el ID del
+ * formato, un timestamp en us (timebase) y los argumentos crudos. Se decodifica en el host
+ * con tools/logger_decode.py */
+#define LOGGER_CONFIG_USE_BINARY                (0)
+#define LOGGER_CONFIG_BINARY_FILE               "logger.bin"   // semihosting
+
+#define LOGGER_BINARY_SYNC                      (0xA0)
+#define LOGGER_BINARY_ID_DROPPED                (0xFFFF)
+
+#if (1 == LOGGER_CONFIG_USE_SEMIHOSTING) && (1 == LOGGER_CONFIG_USE_UART_DMA)
+#error "Elegir un solo transporte: LOGGER_CONFIG_USE_SEMIHOSTING o LOGGER_CONFIG_USE_UART_DMA"
+#endif
+
+#if (1 == LOGGER_CONFIG_USE_BINARY) && (1 != LOGGER_CONFIG_USE_DEFERRED)
+#error "LOGGER_CONFIG_USE_BINARY requiere LOGGER_CONFIG_USE_DEFERRED"
+#endif
 
 #if 1 == LOGGER_CONFIG_ENABLE
 #define LOGGER_LOG(...)\
-    taskENTER_CRITICAL();\
+    CRITICAL_ENTER(CRITICAL_SITE_LOGGER_LOG);\
     {\
         logger_msg_len = snprintf(logger_msg, (LOGGER_CONFIG_MAXLEN - 1), __VA_ARGS__);\
         logger_log_print_(logger_msg);\
     }\
-    taskEXIT_CRITICAL()
+    CRITICAL_EXIT()
 #else
 #define LOGGER_LOG(...)
 #endif
 
-#define LOGGER_INFO(...)\
-    LOGGER_LOG("[info] ");\
-    LOGGER_LOG(__VA_ARGS__);\
-    LOGGER_LOG("\n");
+/* Cuenta los argumentos de la llamada, incluido el formato. La secuencia
+ * llega a 16 para que una llamada con mas de 8 falle en el _Static_assert
+ * de LOGGER_EMIT_ en lugar de contarse mal */
+#define LOGGER_NARGS_(...)  LOGGER_NARGS_SEQ_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOGGER_NARGS_SEQ_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+
+/* El registro diferido guarda palabras y logger_deferred_push_ las lee con
+ * va_arg(ap, uintptr_t): cada argumento se convierte en la llamada (leer un
+ * int como uintptr_t no esta definido y falla en el host de 64 bits) */
+#define LOGGER_ARGS_(n, ...)            LOGGER_ARGS__(n, __VA_ARGS__)
+#define LOGGER_ARGS__(n, ...)           LOGGER_ARGS_##n(__VA_ARGS__)
+#define LOGGER_ARGS_1(...)
+#define LOGGER_ARGS_2(a)                , (uintptr_t)(a)
+#define LOGGER_ARGS_3(a, ...)           , (uintptr_t)(a) LOGGER_ARGS_2(__VA_ARGS__)
+#define LOGGER_ARGS_4(a, ...)           , (uintptr_t)(a) LOGGER_ARGS_3(__VA_ARGS__)
+#define LOGGER_ARGS_5(a, ...)           , (uintptr_t)(a) LOGGER_ARGS_4(__VA_ARGS__)
+#define LOGGER_ARGS_6(a, ...)           , (uintptr_t)(a) LOGGER_ARGS_5(__VA_ARGS__)
+#define LOGGER_ARGS_7(a, ...)           , (uintptr_t)(a) LOGGER_ARGS_6(__VA_ARGS__)
+#define LOGGER_ARGS_8(a, ...)           , (uintptr_t)(a) LOGGER_ARGS_7(__VA_ARGS__)
+
+#define LOGGER_NARGS_CHECK_(n)\
+    _Static_assert(((n) - 1) <= LOGGER_CONFIG_DEFERRED_MAX_ARGS,\
+                   "LOGGER_*: mas argumentos que LOGGER_CONFIG_DEFERRED_MAX_ARGS")
+
+// logger_deferred_print_ pasa siempre a[0..3]
+_Static_assert(4 == LOGGER_CONFIG_DEFERRED_MAX_ARGS, "logger_deferred_print_ formatea exactamente 4 argumentos");
+
+#if 1 == LOGGER_CONFIG_USE_BINARY
+/* El formato tiene que ser un literal; el ID es su offset en .logger_fmt */
+#define LOGGER_EMIT_(prefix, ...)\
+    LOGGER_BINARY_PUSH_(prefix, LOGGER_NARGS_(__VA_ARGS__), __VA_ARGS__)
+#define LOGGER_BINARY_PUSH_(prefix, n, ...)\
+    LOGGER_BINARY_PUSH__(prefix, n, __VA_ARGS__)
+#define LOGGER_BINARY_PUSH__(prefix, n, fmt, ...)\
+    do {\
+        LOGGER_NARGS_CHECK_(n);\
+        static const char logger_fmt_[] __attribute__((section(".logger_fmt"), used)) = prefix fmt;\
+        logger_deferred_push_(NULL, (n) - 1, logger_fmt_ LOGGER_ARGS_(n, __VA_ARGS__));\
+    } while (0)
+#elif 1 == LOGGER_CONFIG_USE_DEFERRED
+/* Los argumentos %s deben apuntar a memoria que siga viva cuando se imprima
+ * (literales o tablas constantes como led_color_name[]). */
+#define LOGGER_EMIT_(prefix, ...)\
+    LOGGER_DEFERRED_PUSH_(prefix, LOGGER_NARGS_(__VA_ARGS__), __VA_ARGS__)
+#define LOGGER_DEFERRED_PUSH_(prefix, n, ...)\
+    LOGGER_DEFERRED_PUSH__(prefix, n, __VA_ARGS__)
+#define LOGGER_DEFERRED_PUSH__(prefix, n, fmt, ...)\
+    do {\
+        LOGGER_NARGS_CHECK_(n);\
+        logger_deferred_push_(prefix, (n) - 1, fmt LOGGER_ARGS_(n, __VA_ARGS__));\
+    } while (0)
+#else
+#define LOGGER_EMIT_(prefix, ...)\
+    logger_log_record_(prefix, __VA_ARGS__)
+#endif
+
+/* Mascara en runtime: un bit por (modulo, nivel), una carga y un salto */
+#define LOGGER_RUNTIME_BIT_(module, level)  (1UL << (((module) * LOGGER_LEVEL_TRACE) + ((level) - 1)))
+
+// logger_runtime_mask es de 32 bits: entran 6 modulos
+_Static_assert((LOGGER_MODULE__N * LOGGER_LEVEL_TRACE) <= 32, "LOGGER_MODULE__N no entra en logger_runtime_mask");
+
+#define LOGGER_LOG_MODULE_(module, level, prefix, ...)\
+    LOGGER_LOG_MODULE__(module, level, prefix, __VA_ARGS__)
+#define LOGGER_LOG_MODULE__(module, level, prefix, ...)\
+    do {\
+        if ((1 == LOGGER_CONFIG_ENABLE) && ((level) <= LOGGER_CONFIG_LEVEL_##module))\
+        {\
+            if (0 != (logger_runtime_mask & LOGGER_RUNTIME_BIT_(LOGGER_MODULE_##module, (level))))\
+            {\
+                LOGGER_EMIT_(prefix, __VA_ARGS__);\
+            }\
+        }\
+    } while (0)
+
+#define LOGGER_ERROR_M(module, ...) LOGGER_LOG_MODULE_(module, LOGGER_LEVEL_ERROR, "[error] ", __VA_ARGS__)
+#define LOGGER_WARN_M(module, ...)  LOGGER_LOG_MODULE_(module, LOGGER_LEVEL_WARN,  "[warn] ",  __VA_ARGS__)
+#define LOGGER_INFO_M(module, ...)  LOGGER_LOG_MODULE_(module, LOGGER_LEVEL_INFO,  "[info] ",  __VA_ARGS__)
+#define LOGGER_DEBUG_M(module, ...) LOGGER_LOG_MODULE_(module, LOGGER_LEVEL_DEBUG, "[debug] ", __VA_ARGS__)
+#define LOGGER_TRACE_M(module, ...) LOGGER_LOG_MODULE_(module, LOGGER_LEVEL_TRACE, "[trace] ", __VA_ARGS__)
+
+#define LOGGER_ERROR(...)           LOGGER_ERROR_M(LOGGER_MODULE, __VA_ARGS__)
+#define LOGGER_WARN(...)            LOGGER_WARN_M(LOGGER_MODULE, __VA_ARGS__)
+#define LOGGER_INFO(...)            LOGGER_INFO_M(LOGGER_MODULE, __VA_ARGS__)
+#define LOGGER_DEBUG(...)           LOGGER_DEBUG_M(LOGGER_MODULE, __VA_ARGS__)
+#define LOGGER_TRACE(...)           LOGGER_TRACE_M(LOGGER_MODULE, __VA_ARGS__)
 
 #define GET_NAME(var)  #var
 
 /********************** typedef **********************************************/
 
+typedef struct
+{
+    uint32_t pushed;
+    uint32_t printed;
+    uint32_t dropped;
+    uint32_t max_used;
+    uint32_t truncated;
+    uint32_t cycles_last;   // costo para el llamador del ultimo LOGGER_INFO
+    uint32_t cycles_max;
+    uint32_t transport_bytes;       // bytes entregados al transporte
+    uint32_t transport_chunks;      // transferencias DMA lanzadas
+    uint32_t transport_used;        // bytes pendientes en el buffer de llenado
+    uint32_t transport_max_used;
+    uint32_t transport_overruns;    // registros descartados por buffer lleno
+} logger_stats_t;
+
 extern char* const logger_msg;
 extern int logger_msg_len; // only for debug information
+extern volatile uint32_t logger_runtime_mask;
 
 /********************** external functions declaration ***********************/
 
+void logger_init(void);
+void logger_flush(void);
+void logger_get_stats(logger_stats_t* pstats);
+void logger_set_level(uint32_t module, uint32_t level);
+void logger_uart_tx_complete_isr(void* huart);
+
 void logger_log_print_(char* const msg);
+void logger_log_record_(const char* prefix, const char* fmt, ...);
+void logger_log_write_(const uint8_t* data, size_t size);
+bool logger_deferred_push_(const char* prefix, uint32_t nargs, const char* fmt, ...);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
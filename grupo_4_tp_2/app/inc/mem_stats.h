@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : mem_stats.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_MEM_STATS_H_
+#define INC_MEM_STATS_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+/********************** macros ***********************************************/
+
+/* Margen minimo de stack de cada tarea (high-water mark) y estado del heap.
+ * Las tareas que se eliminan y se vuelven a crear con el mismo nombre (objetos
+ * activos) conservan el minimo de todas sus vidas */
+#define MEM_STATS_CONFIG_ENABLE                 (1)
+#define MEM_STATS_CONFIG_MAX_TASKS              (16)    // ~12 tareas + eliminadas que espera la idle
+#define MEM_STATS_CONFIG_REPORT_PERIOD_MS       (10000)
+#define MEM_STATS_CONFIG_STACK_WARN_WORDS       (32)    // menos libre: aviso
+#define MEM_STATS_CONFIG_TASK_PRIORITY          (tskIDLE_PRIORITY + 1)
+#define MEM_STATS_CONFIG_TASK_STACK_SIZE        (192)
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t stack_free_min;    // palabras, minimo historico
+    bool alive;                 // existe en el ultimo muestreo
+} mem_stats_task_t;
+
+typedef struct
+{
+    uint32_t heap_free;         // bytes
+    uint32_t heap_free_min;     // minimo desde el arranque
+    uint32_t heap_largest_free; // bloque mas grande: mide la fragmentacion
+    uint32_t heap_free_blocks;
+    uint32_t heap_allocs;
+    uint32_t heap_frees;
+    uint32_t malloc_failed;
+    uint32_t count;             // tareas con historia
+    uint32_t alive;             // tareas existentes
+    bool truncated;             // mas de MAX_TASKS: stacks del muestreo anterior
+    mem_stats_task_t task[MEM_STATS_CONFIG_MAX_TASKS];
+} mem_stats_snapshot_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void mem_stats_init(void);
+bool mem_stats_snapshot(mem_stats_snapshot_t* psnapshot);
+void mem_stats_report(const mem_stats_snapshot_t* psnapshot);
+void task_mem_stats(void* argument);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MEM_STATS_H_ */
+/********************** end of file ******************************************/
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : memory_pool.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_MEMORY_POOL_H_
+#define INC_MEMORY_POOL_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/********************** macros ***********************************************/
+
+/* Reserva estatica para count bloques de type, alineados para cualquier uso */
+#define MEMORY_POOL_STORAGE(name, type, count)\
+    static union\
+    {\
+        type block;\
+        void* next;\
+        uint64_t align;\
+    } name[count]
+
+#define MEMORY_POOL_INIT(pool, storage)\
+    memory_pool_init((pool), #storage, (storage), sizeof((storage)[0]), (sizeof(storage) / sizeof((storage)[0])))
+
+#define MEMORY_POOL_GET(pool, type)     ((type*)memory_pool_block_get(pool))
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+    const char* name;
+    uint8_t* begin;
+    uint8_t* end;
+    size_t block_size;
+    size_t block_count;
+    void* free_list;
+    uint32_t used;
+    uint32_t high_water;    // maximo de bloques usados a la vez
+    uint32_t exhausted;     // pedidos que encontraron el pool vacio
+} memory_pool_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void memory_pool_init(memory_pool_t* pool, const char* name, void* storage, size_t block_size, size_t block_count);
+void* memory_pool_block_get(memory_pool_t* pool);
+bool memory_pool_block_put(memory_pool_t* pool, void* block);
+bool memory_pool_owns(const memory_pool_t* pool, const void* block);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MEMORY_POOL_H_ */
+/********************** end of file ******************************************/
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : profiler.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "dwt.h"
+
+/********************** macros ***********************************************/
+
+/* Puntos de medicion con el DWT: cantidad, min, max, promedio y un histograma
+ * log2 por punto. La resta sin signo tolera un desborde del CYCCNT, asi que un
+ * intervalo puede durar hasta ~51 s a 84 MHz */
+#define PROFILER_CONFIG_ENABLE                  (1)
+#define PROFILER_CONFIG_HISTOGRAM_BINS          (24)    // bin k: [2^(k-1), 2^k) ciclos
+
+#if 1 == PROFILER_CONFIG_ENABLE
+#define PROFILER_BEGIN(probe)                   uint32_t profiler_t0_##probe = cycle_counter_get()
+#define PROFILER_END(probe)                     profiler_record((probe), cycle_counter_elapsed(profiler_t0_##probe))
+#else
+#define PROFILER_BEGIN(probe)
+#define PROFILER_END(probe)
+#endif
+
+/********************** typedef **********************************************/
+
+/* Etapas del camino pulsador -> LED */
+typedef enum
+{
+    PROFILER_PROBE_BUTTON_ISR,          // EXTI del pulsador
+    PROFILER_PROBE_BUTTON_ENGINE,       // antirrebote y clasificacion
+    PROFILER_PROBE_AO_UI,               // dispatch de ao_ui
+    PROFILER_PROBE_AO_LED,              // dispatch de ao_led
+    PROFILER_PROBE_LOGGER,              // encolado/impresion de un registro
+    PROFILER_PROBE_TICKLESS_WAKE,       // WFI -> IRQ que desperto atendida
+    PROFILER_PROBE__N,
+} profiler_probe_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t histogram[PROFILER_CONFIG_HISTOGRAM_BINS];
+} profiler_stats_t;
+
+/********************** external data declaration ****************************/
+
+extern const char* const profiler_probe_name[];
+
+/********************** external functions declaration ***********************/
+
+void profiler_init(void);
+void profiler_record(profiler_probe_t probe, uint32_t cycles);
+bool profiler_get(profiler_probe_t probe, profiler_stats_t* pstats);
+void profiler_reset(void);
+void profiler_report(void);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_PROFILER_H_ */
+/********************** end of file ******************************************/
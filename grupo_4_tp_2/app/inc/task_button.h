@@ -45,6 +45,8 @@ extern "C" {
 
 /********************** inclusions *******************************************/
 
+#include <stdint.h>
+
 /********************** macros ***********************************************/
 
 /********************** typedef **********************************************/
@@ -54,6 +56,7 @@ extern "C" {
 /********************** external functions declaration ***********************/
 
 void task_button(void* argument);
+void button_exti_isr(uint16_t pin);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
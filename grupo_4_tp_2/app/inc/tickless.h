@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : tickless.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TICKLESS_H_
+#define INC_TICKLESS_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+/* Se incluye desde FreeRTOSConfig.h: sin dependencias de FreeRTOS */
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Idle sin tick (configUSE_TICKLESS_IDLE = 2): con la CPU ociosa se detiene
+ * SysTick, el despertar lo programa el canal 1 de TIM2 (timebase) y el tick se
+ * corrige con el tiempo medido por TIM2, sin deriva acumulada. El nucleo entra
+ * en Sleep (WFI): Stop detendria TIM2 y el timebase */
+#define TICKLESS_CONFIG_ENABLE                  (1)
+#define TICKLESS_CONFIG_MAX_IDLE_TICKS          (60000)     // ~60 s por sleep
+
+#if 1 == TICKLESS_CONFIG_ENABLE
+#define portSUPPRESS_TICKS_AND_SLEEP(idle_ticks)    tickless_sleep_((uint32_t)(idle_ticks))
+#else
+#define portSUPPRESS_TICKS_AND_SLEEP(idle_ticks)    ((void)(idle_ticks))
+#endif
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+    uint32_t sleeps;
+    uint32_t aborted;               // cancelados por un cambio de contexto pendiente
+    uint32_t ticks_expected;        // ticks pedidos por el kernel
+    uint32_t ticks_slept;           // ticks corregidos con vTaskStepTick
+    uint64_t slept_us;
+    uint32_t wake_cycles_last;      // WFI -> ISR que desperto atendida
+    uint32_t wake_cycles_max;
+} tickless_stats_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void tickless_get_stats(tickless_stats_t* pstats);
+void tickless_report(void);
+
+void tickless_sleep_(uint32_t expected_idle_ticks);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TICKLESS_H_ */
+/********************** end of file ******************************************/
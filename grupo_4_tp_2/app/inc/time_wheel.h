@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : time_wheel.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TIME_WHEEL_H_
+#define INC_TIME_WHEEL_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* 4 niveles de 64 ranuras: cada nivel cubre 64 veces el rango del anterior */
+#define TIME_WHEEL_LEVEL_BITS           (6)
+#define TIME_WHEEL_SLOTS                (1UL << TIME_WHEEL_LEVEL_BITS)
+#define TIME_WHEEL_LEVELS               (4)
+
+/* Mayor distancia entre el vencimiento y el tick de la rueda (~4.6 h a 1 kHz) */
+#define TIME_WHEEL_MAX_DELAY            ((1UL << (TIME_WHEEL_LEVEL_BITS * TIME_WHEEL_LEVELS)) - 1)
+
+/* time_wheel_next: no hay timers armados */
+#define TIME_WHEEL_NONE                 (UINT32_MAX)
+
+/********************** typedef **********************************************/
+
+typedef struct time_wheel_timer_s time_wheel_timer_t;
+
+typedef void (*time_wheel_cb_t)(time_wheel_timer_t* ptimer);
+
+/* Timer intrusivo: lo reserva el usuario, la rueda solo lo enlaza */
+struct time_wheel_timer_s
+{
+	time_wheel_timer_t* next;
+	time_wheel_timer_t** pprev;     // NULL: desarmado. Permite quitarlo en O(1)
+	uint32_t expires;               // tick absoluto
+	uint32_t period;                // 0: un solo disparo
+	uint8_t level;
+	uint8_t slot;
+	time_wheel_cb_t callback;
+};
+
+/* Rueda jerarquica sin dependencias de HAL ni RTOS: los ticks son un contador
+ * libre de 32 bits (se admite el desborde) */
+typedef struct
+{
+	uint32_t now;                   // proximo tick a procesar
+	uint32_t count;                 // timers armados
+	uint32_t cascaded;              // timers movidos a un nivel inferior
+	uint64_t occupied[TIME_WHEEL_LEVELS];   // un bit por ranura no vacia
+	time_wheel_timer_t* slot[TIME_WHEEL_LEVELS][TIME_WHEEL_SLOTS];
+} time_wheel_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void time_wheel_init(time_wheel_t* pwheel, uint32_t now);
+void time_wheel_timer_init(time_wheel_timer_t* ptimer, time_wheel_cb_t callback);
+bool time_wheel_arm(time_wheel_t* pwheel, time_wheel_timer_t* ptimer, uint32_t expires, uint32_t period);
+bool time_wheel_cancel(time_wheel_t* pwheel, time_wheel_timer_t* ptimer);
+bool time_wheel_is_armed(const time_wheel_timer_t* ptimer);
+uint32_t time_wheel_advance(time_wheel_t* pwheel, uint32_t until);
+uint32_t time_wheel_next(const time_wheel_t* pwheel);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TIME_WHEEL_H_ */
+/********************** end of file ******************************************/
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : tlsf.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TLSF_H_
+#define INC_TLSF_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/********************** macros ***********************************************/
+
+/* TLSF (two-level segregated fit): listas libres por clase de tamano con dos
+ * niveles de bitmaps. malloc y free hacen un numero fijo de pasos (CLZ/CTZ
+ * sobre los bitmaps), sin recorrer listas */
+#define TLSF_CONFIG_SL_LOG2             (3)     // 8 sublistas por potencia de 2
+#define TLSF_CONFIG_FL_MAX              (16)    // bloques de hasta 64 KiB
+
+#define TLSF_ALIGN_LOG2                 (3)
+#define TLSF_ALIGN                      (1UL << TLSF_ALIGN_LOG2)    // portBYTE_ALIGNMENT
+#define TLSF_SL_COUNT                   (1UL << TLSF_CONFIG_SL_LOG2)
+#define TLSF_FL_SHIFT                   (TLSF_CONFIG_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT                   (TLSF_CONFIG_FL_MAX - TLSF_FL_SHIFT + 1)
+
+/********************** typedef **********************************************/
+
+typedef struct tlsf_block_s tlsf_block_t;
+
+/* Cabecera de bloque: 2 palabras (8 bytes en el M4, como heap_4) */
+struct tlsf_block_s
+{
+	tlsf_block_t* prev_phys;        // bloque anterior en memoria (NULL: el primero)
+	size_t size;                    // bytes de datos; bit 0: libre
+	tlsf_block_t* next_free;        // solo en bloques libres, dentro de los datos
+	tlsf_block_t* prev_free;
+};
+
+typedef struct
+{
+	size_t size;                    // bytes de datos del bloque inicial
+	size_t free;
+	size_t free_min;                // minimo historico de free
+	size_t largest_free;
+	size_t largest_alloc;           // mayor pedido que tlsf_malloc garantiza
+	size_t smallest_free;
+	uint32_t free_blocks;
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t failed;
+} tlsf_stats_t;
+
+/* Sin locks: el llamador serializa (heap_tlsf.c, o una sola tarea) */
+typedef struct
+{
+	uint32_t fl_bitmap;
+	uint32_t sl_bitmap[TLSF_FL_COUNT];
+	tlsf_block_t* free_list[TLSF_FL_COUNT][TLSF_SL_COUNT];
+	tlsf_block_t* first;
+	size_t size;
+	size_t free;
+	size_t free_min;
+	uint32_t free_blocks;
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t failed;
+} tlsf_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+bool tlsf_init(tlsf_t* ptlsf, void* memory, size_t bytes);
+void* tlsf_malloc(tlsf_t* ptlsf, size_t size);
+void tlsf_free(tlsf_t* ptlsf, void* ptr);
+bool tlsf_is_allocated(const tlsf_t* ptlsf, const void* ptr);
+size_t tlsf_block_size(const void* ptr);
+void tlsf_get_stats(const tlsf_t* ptlsf, tlsf_stats_t* pstats);
+bool tlsf_check(const tlsf_t* ptlsf);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TLSF_H_ */
+/********************** end of file ******************************************/
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : trace.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+/* Se incluye desde FreeRTOSConfig.h: no depende de headers de FreeRTOS */
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Registro de eventos del kernel en RAM (buffer circular). Se lee con
+ * trace_dump() por la UART o con el debugger (simbolo trace_dump_buffer) y
+ * se analiza con tools/trace_view.py */
+#define TRACE_CONFIG_ENABLE             (0)
+#define TRACE_CONFIG_RECORDS            (512)   // potencia de 2
+/* Los nombres se guardan en la ranura numero % TRACE_CONFIG_MAX_TASKS. Los AO
+ * se destruyen y recrean por inactividad con numeros nuevos: pasadas 16
+ * creaciones una tarea nueva pisa la ranura de una vieja. name_task dice de
+ * quien es cada ranura y las tareas sin ranura se muestran como task#N */
+#define TRACE_CONFIG_MAX_TASKS          (16)
+#define TRACE_CONFIG_NAME_LEN           (16)
+#define TRACE_CONFIG_TRACE_MALLOC       (1)
+
+#define TRACE_MAGIC                     (0x31435254)    // "TRC1"
+#define TRACE_VERSION                   (2)
+
+#if (1 == TRACE_CONFIG_ENABLE)
+
+#define TRACE_ISR_ENTER(irq)            trace_event_(TRACE_EVENT_ISR_ENTER, (uint16_t)(irq), 0)
+#define TRACE_ISR_EXIT(irq)             trace_event_(TRACE_EVENT_ISR_EXIT, (uint16_t)(irq), 0)
+
+/* Hooks de FreeRTOS: se expanden dentro de tasks.c/queue.c/heap_4.c */
+#define traceTASK_SWITCHED_OUT()        trace_task_switched_out_((uint32_t)pxCurrentTCB->uxTCBNumber)
+#define traceTASK_SWITCHED_IN()         trace_task_switched_in_((uint32_t)pxCurrentTCB->uxTCBNumber)
+#define traceTASK_CREATE(pxNewTCB)      trace_task_create_((uint32_t)(pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName)
+#define traceTASK_DELETE(pxTCB)         trace_event_(TRACE_EVENT_TASK_DELETE, 0, (uint32_t)(pxTCB)->uxTCBNumber)
+
+#define traceQUEUE_CREATE(pxQueue)                  trace_event_(TRACE_EVENT_QUEUE_CREATE, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_DELETE(pxQueue)                  trace_event_(TRACE_EVENT_QUEUE_DELETE, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_SEND(pxQueue)                    trace_event_(TRACE_EVENT_QUEUE_SEND, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_SEND_FAILED(pxQueue)             trace_event_(TRACE_EVENT_QUEUE_SEND_FAILED, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)           trace_event_(TRACE_EVENT_QUEUE_SEND_FROM_ISR, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue)                 trace_event_(TRACE_EVENT_QUEUE_RECEIVE, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)          trace_event_(TRACE_EVENT_QUEUE_RECEIVE_FAILED, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)        trace_event_(TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)        trace_event_(TRACE_EVENT_QUEUE_BLOCK_SEND, 0, (uint32_t)(uintptr_t)(pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)     trace_event_(TRACE_EVENT_QUEUE_BLOCK_RECEIVE, 0, (uint32_t)(uintptr_t)(pxQueue))
+
+#if (1 == TRACE_CONFIG_TRACE_MALLOC)
+#define traceMALLOC(pvAddress, uiSize)  trace_event_(TRACE_EVENT_MALLOC, (uint16_t)(uiSize), (uint32_t)(uintptr_t)(pvAddress))
+#define traceFREE(pvAddress, uiSize)    trace_event_(TRACE_EVENT_FREE, (uint16_t)(uiSize), (uint32_t)(uintptr_t)(pvAddress))
+#endif
+
+#else
+
+#define TRACE_ISR_ENTER(irq)
+#define TRACE_ISR_EXIT(irq)
+
+#endif
+
+/********************** typedef **********************************************/
+
+typedef enum
+{
+    TRACE_EVENT_NONE,
+    TRACE_EVENT_TASK_SWITCH_IN,         // arg: tarea que entra
+    TRACE_EVENT_TASK_SWITCH_OUT,        // arg: tarea que sale
+    TRACE_EVENT_TASK_CREATE,            // arg: tarea creada
+    TRACE_EVENT_TASK_DELETE,            // arg: tarea eliminada
+    TRACE_EVENT_QUEUE_CREATE,           // arg: direccion de la cola
+    TRACE_EVENT_QUEUE_DELETE,
+    TRACE_EVENT_QUEUE_SEND,
+    TRACE_EVENT_QUEUE_SEND_FAILED,
+    TRACE_EVENT_QUEUE_SEND_FROM_ISR,
+    TRACE_EVENT_QUEUE_RECEIVE,
+    TRACE_EVENT_QUEUE_RECEIVE_FAILED,
+    TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR,
+    TRACE_EVENT_QUEUE_BLOCK_SEND,
+    TRACE_EVENT_QUEUE_BLOCK_RECEIVE,
+    TRACE_EVENT_MALLOC,                 // aux: tamano, arg: direccion
+    TRACE_EVENT_FREE,
+    TRACE_EVENT_ISR_ENTER,              // aux: IRQn
+    TRACE_EVENT_ISR_EXIT,
+    TRACE_EVENT_USER,
+    TRACE_EVENT__N,
+} trace_event_t;
+
+typedef struct
+{
+    uint32_t timestamp;                 // ciclos DWT
+    uint8_t event;
+    uint8_t task;                       // tarea en ejecucion al registrar
+    uint16_t aux;
+    uint32_t arg;
+} trace_record_t;
+
+/* Imagen que se vuelca entera (little endian) */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t head;                      // registros escritos desde trace_init
+    uint32_t clock_hz;
+    uint32_t overhead_cycles;           // costo medido de un registro
+    uint32_t name_task[TRACE_CONFIG_MAX_TASKS];     // numero de tarea de cada nombre (0: libre)
+    char names[TRACE_CONFIG_MAX_TASKS][TRACE_CONFIG_NAME_LEN];
+    trace_record_t records[TRACE_CONFIG_RECORDS];
+} trace_dump_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void trace_init(void);
+void trace_start(void);
+void trace_stop(void);
+void trace_user(uint16_t aux, uint32_t arg);
+void trace_dump(void);
+
+void trace_event_(uint8_t event, uint16_t aux, uint32_t arg);
+void trace_task_switched_out_(uint32_t task);
+void trace_task_switched_in_(uint32_t task);
+void trace_task_create_(uint32_t task, const char* name);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TRACE_H_ */
+/********************** end of file ******************************************/
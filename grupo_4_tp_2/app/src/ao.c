@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : ao.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+#include "critical.h"
+
+#include "ao.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+typedef union
+{
+    uint8_t raw[AO_CONFIG_EVENT_SIZE_MAX];
+    uint64_t align;
+} ao_event_buffer_t;
+
+/********************** internal functions declaration ***********************/
+
+#if (1 == AO_CONFIG_KERNEL_QV)
+static void ao_qv_task_(void* argument);
+#else
+static void ao_task_(void* argument);
+#endif
+
+/********************** internal data definition *****************************/
+
+#if (1 == AO_CONFIG_KERNEL_QV)
+static ao_t* ao_qv_table_[AO_CONFIG_QV_MAX_OBJECTS];    // indice = bit de prioridad
+static uint32_t ao_qv_count_;
+static volatile uint32_t ao_qv_ready_;
+static TaskHandle_t ao_qv_htask_;
+#endif
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+static void ao_dispatch_(ao_t* self, void* pevent)
+{
+    UBaseType_t used = uxQueueMessagesWaiting(self->hqueue) + 1;
+    if (used > self->stats.queue_max_used)
+    {
+        self->stats.queue_max_used = used;
+    }
+
+    uint32_t t0 = cycle_counter_get();
+    self->config->vtable->dispatch(self, pevent);
+    uint32_t cycles = cycle_counter_get() - t0;
+
+    self->stats.dispatched++;
+    self->stats.cycles_last = cycles;
+    if (cycles > self->stats.cycles_max)
+    {
+        self->stats.cycles_max = cycles;
+    }
+}
+
+static QueueHandle_t ao_queue_create_(const ao_config_t* config)
+{
+    if (NULL != config->storage)
+    {
+        return xQueueCreateStatic(config->queue_length, config->event_size,
+                                  config->storage->queue_buffer, &config->storage->queue);
+    }
+    return xQueueCreate(config->queue_length, config->event_size);
+}
+
+#if (1 == AO_CONFIG_KERNEL_QV)
+
+/* Inserta el objeto ordenado por prioridad y renumera los bits */
+static void ao_qv_register_(ao_t* self)
+{
+    configASSERT(ao_qv_count_ < AO_CONFIG_QV_MAX_OBJECTS);
+
+    uint32_t i = ao_qv_count_;
+    while ((0 < i) && (ao_qv_table_[i - 1]->config->priority > self->config->priority))
+    {
+        ao_qv_table_[i] = ao_qv_table_[i - 1];
+        i--;
+    }
+    ao_qv_table_[i] = self;
+    ao_qv_count_++;
+
+    for (i = 0; i < ao_qv_count_; i++)
+    {
+        ao_qv_table_[i]->qv_bit = i;
+    }
+}
+
+/* Loop del kernel: toma un evento del objeto listo de mayor prioridad y lo
+ * despacha hasta completar. Sin objetos listos la tarea se bloquea y el
+ * sistema cae en la tarea idle */
+static void ao_qv_task_(void* argument)
+{
+    ao_event_buffer_t event;
+
+    for (uint32_t i = 0; i < ao_qv_count_; i++)
+    {
+        if (NULL != ao_qv_table_[i]->config->vtable->init)
+        {
+            ao_qv_table_[i]->config->vtable->init(ao_qv_table_[i]);
+        }
+    }
+
+    while (true)
+    {
+        uint32_t ready = ao_qv_ready_;
+        if (0 == ready)
+        {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        uint32_t bit = 31 - __CLZ(ready);
+        ao_t* self = ao_qv_table_[bit];
+
+        if (pdPASS == xQueueReceive(self->hqueue, &event, 0))
+        {
+            ao_dispatch_(self, &event);
+        }
+
+        CRITICAL_ENTER(CRITICAL_SITE_AO_QV_READY);
+        {
+            if (0 == uxQueueMessagesWaiting(self->hqueue))
+            {
+                ao_qv_ready_ &= ~(1UL << bit);
+            }
+        }
+        CRITICAL_EXIT();
+    }
+}
+
+#else
+
+/* Crea cola y tarea. Se llama con el scheduler suspendido */
+static bool ao_start_(ao_t* self)
+{
+    const ao_config_t* config = self->config;
+
+    LOGGER_DEBUG_M(MEMORY, "Creando cola de %s", config->name);
+    self->hqueue = ao_queue_create_(config);
+    if (NULL == self->hqueue)
+    {
+        LOGGER_ERROR("Error creando cola de %s", config->name);
+        return false;
+    }
+
+    LOGGER_INFO("Creando tarea de %s", config->name);
+    if (NULL != config->storage)
+    {
+        self->htask = xTaskCreateStatic(ao_task_, config->name, config->stack_size, self, config->priority,
+                                        config->storage->stack, &config->storage->task);
+    }
+    else if (pdPASS != xTaskCreate(ao_task_, config->name, config->stack_size, self, config->priority, &self->htask))
+    {
+        self->htask = NULL;
+    }
+    if (NULL == self->htask)
+    {
+        LOGGER_ERROR("Error creando tarea de %s", config->name);
+        vQueueDelete(self->hqueue);
+        self->hqueue = NULL;
+        return false;
+    }
+
+    self->stats.starts++;
+    return true;
+}
+
+/* Elimina la cola si sigue vacia; si entro un evento mientras tanto el objeto
+ * sigue vivo. destroy se llama con el scheduler suspendido (ver ao.h) */
+static bool ao_stop_(ao_t* self)
+{
+    bool stopped = false;
+
+    vTaskSuspendAll();
+    {
+        if (0 == uxQueueMessagesWaiting(self->hqueue))
+        {
+            if (NULL != self->config->vtable->destroy)
+            {
+                self->config->vtable->destroy(self);
+            }
+            LOGGER_DEBUG("%s: eventos=%lu dispatch max=%lu ciclos", self->config->name,
+                         self->stats.dispatched, self->stats.cycles_max);
+            LOGGER_DEBUG_M(MEMORY, "Eliminando cola de %s", self->config->name);
+            vQueueDelete(self->hqueue);
+            self->hqueue = NULL;
+            self->htask = NULL;
+            stopped = true;
+        }
+    }
+    (void)xTaskResumeAll();
+
+    return stopped;
+}
+
+static void ao_task_(void* argument)
+{
+    ao_t* self = (ao_t*)argument;
+    const ao_config_t* config = self->config;
+    TickType_t timeout = (AO_IDLE_FOREVER == config->idle_timeout_ms) ? portMAX_DELAY : pdMS_TO_TICKS(config->idle_timeout_ms);
+    ao_event_buffer_t event;
+
+    if (NULL != config->vtable->init)
+    {
+        config->vtable->init(self);
+    }
+
+    while (true)
+    {
+        if (pdPASS == xQueueReceive(self->hqueue, &event, timeout))
+        {
+            ao_dispatch_(self, &event);
+        }
+        else if (ao_stop_(self))
+        {
+            LOGGER_INFO("Eliminando tarea de %s", config->name);
+            vTaskDelete(NULL);
+        }
+    }
+}
+
+#endif
+
+/********************** external functions definition ************************/
+
+void ao_init(ao_t* self, const ao_config_t* config)
+{
+    configASSERT(NULL != config->vtable->dispatch);
+    configASSERT(config->event_size <= AO_CONFIG_EVENT_SIZE_MAX);
+#if (0 == AO_CONFIG_KERNEL_QV)
+    // Un TCB estatico no se puede reusar hasta que la tarea idle lo libere
+    configASSERT((NULL == config->storage) || (AO_IDLE_FOREVER == config->idle_timeout_ms));
+#endif
+
+    self->config = config;
+    self->hqueue = NULL;
+    self->htask = NULL;
+    self->stats = (ao_stats_t){0};
+
+#if (1 == AO_CONFIG_KERNEL_QV)
+    // La cola se crea aca y el bit de prioridad queda fijo al arrancar el scheduler
+    configASSERT(taskSCHEDULER_NOT_STARTED == xTaskGetSchedulerState());
+
+    self->hqueue = ao_queue_create_(config);
+    configASSERT(NULL != self->hqueue);
+    ao_qv_register_(self);
+
+    if (NULL == ao_qv_htask_)
+    {
+        BaseType_t status;
+        status = xTaskCreate(ao_qv_task_, "ao_qv", AO_CONFIG_QV_TASK_STACK_SIZE, NULL, AO_CONFIG_QV_TASK_PRIORITY, &ao_qv_htask_);
+        while (pdPASS != status)
+        {
+            // error
+        }
+    }
+    self->htask = ao_qv_htask_;
+    self->stats.starts = 1;
+#endif
+}
+
+/* Encola una copia del evento (event_size bytes). La cola y la tarea se crean
+ * con el primer evento (en QV ya existen desde ao_init); no usar desde
+ * interrupciones */
+bool ao_send(ao_t* self, const void* pevent)
+{
+    bool ret = false;
+
+#if (1 == AO_CONFIG_KERNEL_QV)
+    CRITICAL_ENTER(CRITICAL_SITE_AO_SEND);
+    {
+        ret = (pdPASS == xQueueSend(self->hqueue, pevent, 0));
+        if (ret)
+        {
+            ao_qv_ready_ |= (1UL << self->qv_bit);
+        }
+    }
+    CRITICAL_EXIT();
+
+    if (ret)
+    {
+        xTaskNotifyGive(ao_qv_htask_);
+    }
+#else
+    vTaskSuspendAll();
+    {
+        if ((NULL != self->hqueue) || ao_start_(self))
+        {
+            ret = (pdPASS == xQueueSend(self->hqueue, pevent, 0));
+        }
+    }
+    (void)xTaskResumeAll();
+#endif
+
+    if (!ret)
+    {
+        self->stats.send_failed++;
+    }
+    return ret;
+}
+
+bool ao_is_running(const ao_t* self)
+{
+    return (NULL != self->hqueue);
+}
+
+void ao_get_stats(const ao_t* self, ao_stats_t* pstats)
+{
+    *pstats = self->stats;
+}
+
+/********************** end of file ******************************************/
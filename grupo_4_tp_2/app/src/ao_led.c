@@ -47,13 +47,34 @@
 #include "board.h"
 #include "logger.h"
 #include "dwt.h"
+#include "profiler.h"
 
+#include "ao.h"
 #include "ao_led.h"
+#include "ao_timer.h"
+#include "led_pwm.h"
 
 /********************** macros and definitions *******************************/
 
-#define QUEUE_LENGTH_            (10)
+#define LOGGER_MODULE            LED
+
+#define QUEUE_LENGTH_            (AO_LED_QUEUE_LENGTH)
+#if (1 == AO_LED_CONFIG_BY_VALUE)
+#define QUEUE_ITEM_SIZE_         (sizeof(ao_led_message_t))
+#else
 #define QUEUE_ITEM_SIZE_         (sizeof(ao_led_message_t*))
+#endif
+
+#define AO_LED_CONFIG_(task_name) {\
+    .name            = task_name,\
+    .vtable          = &ao_led_vtable_,\
+    .event_size      = QUEUE_ITEM_SIZE_,\
+    .queue_length    = QUEUE_LENGTH_,\
+    .stack_size      = AO_LED_TASK_STACK_SIZE,\
+    .priority        = AO_LED_TASK_PRIORITY,\
+    .idle_timeout_ms = AO_LED_IDLE_TIMEOUT_MS,\
+    .storage         = NULL,\
+}
 
 /********************** external data definition ****************************/
 const char* const led_color_name[] = {
@@ -67,101 +88,245 @@ const char* const led_action_name[] = {
 		"MESSAGE_LED_ON",
 		"MESSAGE_LED_OFF",
 		"MESSAGE_LED_BLINK",
+		"MESSAGE_LED_FADE",
+		"MESSAGE_LED_TOGGLE",
 		"MESSAGE_LED_NONE",
 };
 
+ao_led_handle_t hao_led[AO_LED_COLOR__N] = {
+    {.color = AO_LED_COLOR_RED},
+    {.color = AO_LED_COLOR_GREEN},
+    {.color = AO_LED_COLOR_BLUE}
+};
+
 /********************** internal functions declaration ***********************/
 
+static void ao_led_dispatch_(ao_t* self, void* pevent);
+
 /********************** internal data definition *****************************/
 
+#if (0 == LED_PWM_CONFIG_ENABLE)
 static GPIO_TypeDef* led_port_[] = {LED_RED_PORT, LED_GREEN_PORT,  LED_BLUE_PORT};
 static uint16_t      led_pin_[]  = {LED_RED_PIN,  LED_GREEN_PIN,   LED_BLUE_PIN };
+#endif
 
-ao_led_handle_t hao_led[AO_LED_COLOR__N] = {
-    {.color = AO_LED_COLOR_RED,   .hqueue = NULL},
-    {.color = AO_LED_COLOR_GREEN, .hqueue = NULL},
-    {.color = AO_LED_COLOR_BLUE,  .hqueue = NULL}
+static const ao_vtable_t ao_led_vtable_ = {
+    .init     = NULL,
+    .dispatch = ao_led_dispatch_,
+    .destroy  = NULL,
+};
+
+static const ao_config_t ao_led_config_[AO_LED_COLOR__N] = {
+    AO_LED_CONFIG_("ao_led_red"),
+    AO_LED_CONFIG_("ao_led_green"),
+    AO_LED_CONFIG_("ao_led_blue"),
 };
 
 /********************** internal functions definition ************************/
-static void turn_on_led(ao_led_handle_t* hao)
+
+#if (1 == LED_PWM_CONFIG_ENABLE)
+/* Los tres colores comparten el canal PWM de LD2 en esta placa */
+static void led_write_(ao_led_handle_t* hao, uint16_t level)
 {
-	HAL_GPIO_WritePin(led_port_[hao->color], led_pin_[hao->color], SET);
+	(void)hao;
+	led_pwm_set(level);
+}
+#else
+static void led_write_(ao_led_handle_t* hao, uint16_t level)
+{
+	(void)ao_timer_cancel(&hao->blink);
+	hao->blinking = false;
+	hao->lit = (0 != level);
+	HAL_GPIO_WritePin(led_port_[hao->color], led_pin_[hao->color], hao->lit ? LED_ON : LED_OFF);
+}
+
+/* Evento de tiempo del parpadeo: cambia el pin y arma el proximo flanco. No
+ * lleva sellos: en modo puntero el timer reenvia siempre el mismo toggle_msg
+ * y los flancos del parpadeo no son parte del camino del boton.
+ * ao_timer_cancel no retira un TOGGLE ya encolado: si despues llego un
+ * ON/OFF (no hay parpadeo) o un BLINK nuevo (el timer esta armado otra vez)
+ * el evento es viejo y se ignora */
+static void toggle_led(ao_led_handle_t* hao)
+{
+	if (!hao->blinking || ao_timer_is_armed(&hao->blink))
+	{
+		return;
+	}
+
+	hao->lit = !hao->lit;
+	HAL_GPIO_WritePin(led_port_[hao->color], led_pin_[hao->color], hao->lit ? LED_ON : LED_OFF);
+	(void)ao_timer_arm(&hao->blink, hao->lit ? hao->on_ms : hao->off_ms, 0);
+}
+#endif
+
+static void turn_on_led(ao_led_handle_t* hao, latency_stamp_t* pstamp)
+{
+	led_write_(hao, LED_PWM_LEVEL_MAX);
+	latency_stamp(pstamp, LATENCY_HOP_GPIO);
 	LOGGER_INFO("%s encendido", led_color_name[hao->color]);
 }
 
-static void turn_off_led(ao_led_handle_t* hao)
+static void turn_off_led(ao_led_handle_t* hao, latency_stamp_t* pstamp)
 {
-	HAL_GPIO_WritePin(led_port_[hao->color], led_pin_[hao->color], RESET);
+	led_write_(hao, 0);
+	latency_stamp(pstamp, LATENCY_HOP_GPIO);
 	LOGGER_INFO("%s apagado", led_color_name[hao->color]);
 }
 
-/********************** external functions definition ************************/
-void process_ao_led(ao_led_handle_t* hao)
+static void blink_led(ao_led_handle_t* hao, ao_led_message_t* pmsg)
 {
-	ao_led_message_t* pmsg;
-
-	if(NULL != hao->hqueue)
+	uint16_t period_ms = pmsg->param.blink.period_ms;
+	uint16_t duty = pmsg->param.blink.duty;
+#if (1 == LED_PWM_CONFIG_ENABLE)
+	bool ok = led_pwm_blink(period_ms, duty);
+#else
+	bool ok = (0 != period_ms) && (LED_PWM_LEVEL_MAX >= duty);
+	if (ok)
 	{
-		if (pdPASS == xQueueReceive(hao->hqueue, (void*)&pmsg, 0))
+		led_write_(hao, (0 != duty) ? LED_PWM_LEVEL_MAX : 0);
+		hao->on_ms = (uint16_t)((uint32_t)period_ms * duty / LED_PWM_LEVEL_MAX);
+		hao->off_ms = period_ms - hao->on_ms;
+		if ((0 != hao->on_ms) && (0 != hao->off_ms))
 		{
-			switch (pmsg->action)
-			{
-			case AO_LED_MESSAGE_ON:
-				turn_on_led(hao);
-				break;
-			case AO_LED_MESSAGE_OFF:
-				turn_off_led(hao);
-				break;
-			default:
-				break;
-			}
-
-			if(pmsg->callback)
-			{
-				pmsg->callback(pmsg);
-			}
+			ok = ao_timer_arm(&hao->blink, hao->on_ms, 0);
+			hao->blinking = ok;
 		}
 	}
+#endif
+	latency_stamp(&pmsg->stamp, LATENCY_HOP_GPIO);
+
+	if (ok)
+	{
+		LOGGER_INFO("%s parpadeo %u ms, duty %u", led_color_name[hao->color], period_ms, duty);
+	}
+	else
+	{
+		LOGGER_ERROR("%s parpadeo invalido %u ms", led_color_name[hao->color], period_ms);
+	}
 }
 
-bool ao_led_send_event(ao_led_handle_t* hao, ao_led_message_t* pmsg)
+static void fade_led(ao_led_handle_t* hao, ao_led_message_t* pmsg)
 {
-	if (NULL == hao->hqueue)
+	uint16_t level = pmsg->param.fade.level;
+	uint16_t ms = pmsg->param.fade.ms;
+#if (1 == LED_PWM_CONFIG_ENABLE)
+	bool ok = led_pwm_fade(level, ms);
+#else
+	// Sin PWM no hay brillo intermedio: se salta al final
+	bool ok = true;
+	led_write_(hao, level);
+#endif
+	latency_stamp(&pmsg->stamp, LATENCY_HOP_GPIO);
+
+	if (ok)
 	{
-		LOGGER_INFO("Creando cola de %s", led_color_name[hao->color]);
-		hao->hqueue = xQueueCreate(QUEUE_LENGTH_, sizeof(ao_led_message_t*));
-		if (hao->hqueue == NULL)
-		{
-			LOGGER_INFO("Error creando cola de %s", led_color_name[hao->color]);
-			// error
-			return false;
-		}
+		LOGGER_INFO("%s fundido a %u en %u ms", led_color_name[hao->color], level, ms);
+	}
+	else
+	{
+		LOGGER_ERROR("%s fundido invalido %u ms", led_color_name[hao->color], ms);
+	}
+}
+
+static void ao_led_dispatch_(ao_t* self, void* pevent)
+{
+	PROFILER_BEGIN(PROFILER_PROBE_AO_LED);
+	ao_led_handle_t* hao = (ao_led_handle_t*)self;
+#if (1 == AO_LED_CONFIG_BY_VALUE)
+	ao_led_message_t* pmsg = (ao_led_message_t*)pevent;
+#else
+	ao_led_message_t* pmsg = *(ao_led_message_t**)pevent;
+#endif
+	// Solo se miden los mensajes que traen el flanco de un evento de boton
+	bool timed = (0 != (pmsg->stamp.hops & (1UL << LATENCY_HOP_EDGE)));
+	if (timed)
+	{
+		latency_stamp(&pmsg->stamp, LATENCY_HOP_LED_DISPATCH);
+	}
+
+	switch (pmsg->action)
+	{
+	case AO_LED_MESSAGE_ON:
+		turn_on_led(hao, &pmsg->stamp);
+		break;
+	case AO_LED_MESSAGE_OFF:
+		turn_off_led(hao, &pmsg->stamp);
+		break;
+	case AO_LED_MESSAGE_BLINK:
+		blink_led(hao, pmsg);
+		break;
+	case AO_LED_MESSAGE_FADE:
+		fade_led(hao, pmsg);
+		break;
+#if (0 == LED_PWM_CONFIG_ENABLE)
+	case AO_LED_MESSAGE_TOGGLE:
+		toggle_led(hao);
+		break;
+#endif
+	default:
+		break;
+	}
+	// El sello GPIO se toma antes del log de turn_on/off_led
+	if (timed)
+	{
+		latency_record(&pmsg->stamp);
 	}
 
-	return (pdPASS == xQueueSend(hao->hqueue, (void*)&pmsg, 0));
+	if(pmsg->callback)
+	{
+		pmsg->callback(pmsg);
+	}
+
+	PROFILER_END(PROFILER_PROBE_AO_LED);
 }
 
-void queue_led_delete(ao_led_handle_t* hao)
+/********************** external functions definition ************************/
+void ao_led_init(void)
 {
-	if(NULL != hao->hqueue)
+#if (1 == LED_PWM_CONFIG_ENABLE)
+	led_pwm_init();
+#endif
+
+	for(uint8_t i = 0; i < AO_LED_COLOR__N; i++)
 	{
-		LOGGER_INFO("Eliminando cola de %s", led_color_name[hao->color]);
-		ao_led_message_t *pmsg;
-
-		// Exclusión mutua para evitar que se ingresen mensajes cuando se esta destruyendo el recurso
-		taskENTER_CRITICAL();{
-			while(pdPASS == xQueueReceive(hao->hqueue, (void*)&pmsg, 0))
-			{
-				LOGGER_INFO("Liberando memoria de %s de la cola %s", led_action_name[pmsg->action], led_color_name[hao->color]);
-				vPortFree(pmsg);
-			}
-		}taskEXIT_CRITICAL();
-
-		LOGGER_INFO("Cola %s eliminada", led_color_name[hao->color]);
-		vQueueDelete(hao->hqueue);
-		hao->hqueue = NULL;
+		ao_led_handle_t* hao = &hao_led[i];
+
+		ao_init(&hao->ao, &ao_led_config_[i]);
+
+#if (0 == LED_PWM_CONFIG_ENABLE)
+		// MX_TIM8_Init deja LD2 en modo alternativo: sin PWM vuelve a ser salida
+		GPIO_InitTypeDef GPIO_InitStruct = {0};
+		HAL_GPIO_WritePin(led_port_[i], led_pin_[i], LED_OFF);
+		GPIO_InitStruct.Pin = led_pin_[i];
+		GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+		GPIO_InitStruct.Pull = GPIO_NOPULL;
+		GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+		HAL_GPIO_Init(led_port_[i], &GPIO_InitStruct);
+
+		// Cada LED tiene su propio mensaje de tiempo: nadie lo libera
+		hao->lit = false;
+		hao->blinking = false;
+		hao->toggle_msg.callback = NULL;
+		hao->toggle_msg.action = AO_LED_MESSAGE_TOGGLE;
+		hao->toggle_msg.payload = NULL;
+		latency_stamp_clear(&hao->toggle_msg.stamp);
+#if (1 == AO_LED_CONFIG_BY_VALUE)
+		ao_timer_init(&hao->blink, &hao->ao, &hao->toggle_msg);
+#else
+		hao->ptoggle_msg = &hao->toggle_msg;
+		ao_timer_init(&hao->blink, &hao->ao, &hao->ptoggle_msg);
+#endif
+#endif
 	}
 }
 
+bool ao_led_send_event(ao_led_handle_t* hao, ao_led_message_t* pmsg)
+{
+#if (1 == AO_LED_CONFIG_BY_VALUE)
+	return ao_send(&hao->ao, pmsg);
+#else
+	return ao_send(&hao->ao, &pmsg);
+#endif
+}
+
 /********************** end of file ******************************************/
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : ao_timer.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+
+#include "ao.h"
+#include "ao_timer.h"
+#include "time_wheel.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+static void ao_timer_expired_(time_wheel_timer_t* ptimer);
+static void ao_timer_task_(void* argument);
+
+/********************** internal data definition *****************************/
+
+/* La rueda se toca solo con el scheduler suspendido: armar y cancelar son
+ * O(1) y los vencimientos solo encolan, sin bloquear */
+static time_wheel_t wheel_;
+static TaskHandle_t htask_;
+static volatile TickType_t wake_at_;    // tick en que despierta la tarea del servicio
+static volatile bool sleeping_forever_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+static void ao_timer_expired_(time_wheel_timer_t* ptimer)
+{
+    ao_timer_t* self = (ao_timer_t*)ptimer;
+
+    if (ao_send(self->ao, self->pevent))
+    {
+        self->posted++;
+    }
+    else
+    {
+        self->dropped++;
+    }
+}
+
+/* Duerme hasta el proximo tick que la rueda necesita procesar, asi que sin
+ * vencimientos cercanos no interrumpe el modo tickless */
+static void ao_timer_task_(void* argument)
+{
+    (void)argument;
+
+    while (true)
+    {
+        TickType_t now = xTaskGetTickCount();
+        uint32_t next;
+
+        vTaskSuspendAll();
+        {
+            (void)time_wheel_advance(&wheel_, now);
+            next = time_wheel_next(&wheel_);
+
+            // next cuenta desde el proximo tick sin procesar de la rueda
+            sleeping_forever_ = (TIME_WHEEL_NONE == next);
+            wake_at_ = wheel_.now + next;
+        }
+        (void)xTaskResumeAll();
+
+        (void)ulTaskNotifyTake(pdTRUE, sleeping_forever_ ? portMAX_DELAY : (TickType_t)(wake_at_ - now));
+    }
+}
+
+/********************** external functions definition ************************/
+
+void ao_timer_service_init(void)
+{
+    BaseType_t status;
+
+    time_wheel_init(&wheel_, xTaskGetTickCount());
+    sleeping_forever_ = true;
+
+    status = xTaskCreate(ao_timer_task_, "ao_timer", AO_TIMER_CONFIG_TASK_STACK_SIZE, NULL,
+                         AO_TIMER_CONFIG_TASK_PRIORITY, &htask_);
+    while (pdPASS != status)
+    {
+        // error
+    }
+}
+
+void ao_timer_init(ao_timer_t* self, ao_t* ao, const void* pevent)
+{
+    time_wheel_timer_init(&self->timer, ao_timer_expired_);
+    self->ao = ao;
+    self->pevent = pevent;
+    self->posted = 0;
+    self->dropped = 0;
+}
+
+/* Arma o rearma: primer vencimiento en delay_ms, luego cada period_ms (0: un
+ * solo disparo). Solo desde tareas. Un evento ya encolado no se retira */
+bool ao_timer_arm(ao_timer_t* self, uint32_t delay_ms, uint32_t period_ms)
+{
+    bool ret;
+    bool wake;
+    TickType_t expires;
+
+    vTaskSuspendAll();
+    {
+        TickType_t now = xTaskGetTickCount();
+        if (0 == wheel_.count)
+        {
+            // Rueda vacia: se pone al dia sin costo para no medir desde un tick viejo
+            (void)time_wheel_advance(&wheel_, now);
+        }
+
+        expires = now + pdMS_TO_TICKS(delay_ms);
+        ret = time_wheel_arm(&wheel_, &self->timer, expires, pdMS_TO_TICKS(period_ms));
+        wake = ret && (sleeping_forever_ || ((int32_t)(expires - wake_at_) < 0));
+    }
+    (void)xTaskResumeAll();
+
+    // Solo se despierta al servicio si este vencimiento es anterior al suyo
+    if (wake)
+    {
+        xTaskNotifyGive(htask_);
+    }
+    return ret;
+}
+
+bool ao_timer_cancel(ao_timer_t* self)
+{
+    bool ret;
+
+    vTaskSuspendAll();
+    {
+        ret = time_wheel_cancel(&wheel_, &self->timer);
+    }
+    (void)xTaskResumeAll();
+    return ret;
+}
+
+bool ao_timer_is_armed(const ao_timer_t* self)
+{
+    return time_wheel_is_armed(&self->timer);
+}
+
+/********************** end of file ******************************************/
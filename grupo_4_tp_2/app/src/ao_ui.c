@@ -47,22 +47,29 @@
 #include "board.h"
 #include "logger.h"
 #include "dwt.h"
+#include "memory_pool.h"
+#include "profiler.h"
 
+#include "ao.h"
 #include "ao_ui.h"
 #include "ao_led.h"
 
 /********************** macros and definitions *******************************/
-#define UI_IDLE_TIMEOUT_MS_		 (10000)
 
-#define QUEUE_LENGTH_            (5)
+#define LOGGER_MODULE            UI
+
+#define QUEUE_LENGTH_            (AO_UI_QUEUE_LENGTH)
+#if (1 == AO_UI_CONFIG_BY_VALUE)
+#define QUEUE_ITEM_SIZE_         (sizeof(ao_ui_message_t))
+#else
 #define QUEUE_ITEM_SIZE_         (sizeof(ao_ui_message_t*))
+#endif
 
-/********************** internal data declaration ****************************/
+// Cada transicion usa a lo sumo un OFF y un ON que los LED consumen enseguida
+// (solo en modo por puntero)
+#define LED_MESSAGE_POOL_SIZE_   (2 * AO_LED_COLOR__N)
 
-typedef struct
-{
-	QueueHandle_t hqueue;
-} ao_ui_handle_t;
+/********************** internal data declaration ****************************/
 
 typedef enum {
 	UI_STATE_STANDBY,
@@ -73,14 +80,35 @@ typedef enum {
 
 
 /********************** internal functions declaration ***********************/
-static void queue_ui_delete(void);
+static void ao_ui_dispatch_(ao_t* self, void* pevent);
 
 /********************** internal data definition *****************************/
-static ao_ui_handle_t hao_ui = {.hqueue = NULL};
+static const ao_vtable_t ao_ui_vtable_ = {
+	.init     = NULL,
+	.dispatch = ao_ui_dispatch_,
+	.destroy  = NULL,
+};
 
-/********************** external data definition *****************************/
-extern ao_led_handle_t hao_led[AO_LED_COLOR__N];
+static const ao_config_t ao_ui_config_ = {
+	.name            = "ao_ui",
+	.vtable          = &ao_ui_vtable_,
+	.event_size      = QUEUE_ITEM_SIZE_,
+	.queue_length    = QUEUE_LENGTH_,
+	.stack_size      = AO_UI_TASK_STACK_SIZE,
+	.priority        = AO_UI_TASK_PRIORITY,
+	.idle_timeout_ms = AO_UI_IDLE_TIMEOUT_MS,
+	.storage         = NULL,
+};
+
+static ao_t hao_ui;
+static ui_state_t current_state = UI_STATE_STANDBY;
+
+#if (0 == AO_LED_CONFIG_BY_VALUE)
+MEMORY_POOL_STORAGE(led_message_storage_, ao_led_message_t, LED_MESSAGE_POOL_SIZE_);
+static memory_pool_t led_message_pool_;
+#endif
 
+/********************** external data definition *****************************/
 const char* const button_action_name[] = {
 		  "MESSAGE_BUTTON_NONE",
 		  "MESSAGE_BUTTON_PULSE",
@@ -93,171 +121,164 @@ const char* const button_action_name[] = {
 
 /********************** internal functions definition ************************/
 
+/* Solo el mensaje que cierra el camino del boton lleva sus sellos (pstamp);
+ * el resto va sin sellos y ao_led no lo registra */
+static void ui_stamp_led_(latency_stamp_t* pdst, const latency_stamp_t* pstamp)
+{
+	if (NULL == pstamp)
+	{
+		latency_stamp_clear(pdst);
+		return;
+	}
+	*pdst = *pstamp;
+	latency_stamp(pdst, LATENCY_HOP_LED_SEND);
+}
+
+#if (1 == AO_LED_CONFIG_BY_VALUE)
+static void ui_send_led_(ao_led_handle_t* hao, ao_led_action_t action, const latency_stamp_t* pstamp)
+{
+	// El evento se copia en la cola: no hay memoria que devolver
+	ao_led_message_t msg = {.callback = NULL, .action = action, .payload = NULL};
+	ui_stamp_led_(&msg.stamp, pstamp);
+	if (!ao_led_send_event(hao, &msg))
+	{
+		LOGGER_WARN("No se pudo enviar %s", led_action_name[action]);
+	}
+}
+#else
 static void callback_task_ui(void *pmsg)
 {
 	ao_led_message_t *msg = (ao_led_message_t *)pmsg;
-	LOGGER_INFO("Liberando memoria de %s", led_action_name[msg->action]);
-	vPortFree(pmsg);
+	LOGGER_DEBUG_M(MEMORY, "Liberando memoria de %s", led_action_name[msg->action]);
+	memory_pool_block_put(&led_message_pool_, pmsg);
 }
 
-void task_ui(void* argument)
+static void ui_send_led_(ao_led_handle_t* hao, ao_led_action_t action, const latency_stamp_t* pstamp)
 {
-	static ui_state_t current_state = UI_STATE_STANDBY;
+	LOGGER_DEBUG_M(MEMORY, "Creando %s", led_action_name[action]);
+	ao_led_message_t *pmsg = MEMORY_POOL_GET(&led_message_pool_, ao_led_message_t);
+	if (NULL == pmsg)
+	{
+		LOGGER_WARN("Pool %s agotado", led_message_pool_.name);
+		return;
+	}
 
-	while (true)
+	pmsg->action   = action;
+	pmsg->callback = callback_task_ui;
+	pmsg->payload  = NULL;
+	ui_stamp_led_(&pmsg->stamp, pstamp);
+	if (!ao_led_send_event(hao, pmsg))
 	{
-		ao_ui_message_t *pmsg;
-		if (pdPASS == xQueueReceive(hao_ui.hqueue, &pmsg, pdMS_TO_TICKS(UI_IDLE_TIMEOUT_MS_)))
-		{
-			// 1) Evento -> próximo estado
-			ui_state_t next_state = current_state;
-			switch (pmsg->action) {
-			case MSG_EVENT_BUTTON_PULSE:
-				next_state = UI_STATE_RED;
-				break;
-			case MSG_EVENT_BUTTON_SHORT:
-				next_state = UI_STATE_GREEN;
-				break;
-			case MSG_EVENT_BUTTON_LONG:
-				next_state = UI_STATE_BLUE;
-				break;
-			default:
-				break;
-			}
-
-			// 2) Si cambio el estado: apagar el LED del estado actual
-			if (next_state != current_state)
-			{
-				switch (current_state)
-				{
-				case UI_STATE_STANDBY:
-					break;
-				case UI_STATE_RED:
-				case UI_STATE_GREEN:
-				case UI_STATE_BLUE:
-					LOGGER_INFO("Creando MESSAGE_LED_OFF");
-					ao_led_message_t *pmsg_led_off = (ao_led_message_t*)pvPortMalloc(sizeof(ao_led_message_t));
-					if (NULL != pmsg_led_off)
-					{
-						pmsg_led_off->action   = AO_LED_MESSAGE_OFF;
-						pmsg_led_off->callback = callback_task_ui;
-						ao_led_handle_t *hao =  (current_state == UI_STATE_RED)   ? &hao_led[AO_LED_COLOR_RED]:
-								(current_state == UI_STATE_GREEN) ? &hao_led[AO_LED_COLOR_GREEN]:
-										&hao_led[AO_LED_COLOR_BLUE];
-
-						if (!ao_led_send_event(hao, pmsg_led_off))
-						{
-							LOGGER_INFO("No se pudo enviar MESSAGE_LED_OFF - Liberando memoria");
-							vPortFree(pmsg_led_off);
-						}
-					}
-					break;
-				default:
-					break;
-				}
-
-				// 3a) Encender el LED del nuevo estado (encolo elementos)
-				switch (next_state)
-				{
-				case UI_STATE_STANDBY:
-					break;
-				case UI_STATE_RED:
-				case UI_STATE_GREEN:
-				case UI_STATE_BLUE:
-					LOGGER_INFO("Creando MESSAGE_LED_ON");
-					ao_led_message_t *pmsg_led_on = (ao_led_message_t*)pvPortMalloc(sizeof(ao_led_message_t));
-					if (NULL != pmsg_led_on)
-					{
-						pmsg_led_on->action   = AO_LED_MESSAGE_ON;
-						pmsg_led_on->callback = callback_task_ui;
-						ao_led_handle_t *hao =	(next_state == UI_STATE_RED)   ? &hao_led[AO_LED_COLOR_RED]   :
-								(next_state == UI_STATE_GREEN) ? &hao_led[AO_LED_COLOR_GREEN] :
-										&hao_led[AO_LED_COLOR_BLUE];
-						if (!ao_led_send_event(hao, pmsg_led_on))
-						{
-							LOGGER_INFO("No se pudo enviar MESSAGE_LED_ON - Liberando memoria");
-							vPortFree(pmsg_led_on);
-						}
-					}
-					break;
-
-				default:
-					break;
-				}
-
-				// 3b) Encender el LED del nuevo estado (decolo elementos)
-				for(uint8_t i = 0; i < AO_LED_COLOR__N; i++) process_ao_led(&hao_led[i]);
-
-				// 4) Transicionar
-				current_state = next_state;
-			}
-
-			// 5) Liberar memoria del mensaje
-			if(pmsg->callback)
-			{
-				pmsg->callback(pmsg);
-			}
+		LOGGER_WARN("No se pudo enviar %s - Liberando memoria", led_action_name[action]);
+		memory_pool_block_put(&led_message_pool_, pmsg);
+	}
+}
+#endif
 
+static void ao_ui_dispatch_(ao_t* self, void* pevent)
+{
+	PROFILER_BEGIN(PROFILER_PROBE_AO_UI);
+#if (1 == AO_UI_CONFIG_BY_VALUE)
+	ao_ui_message_t* pmsg = (ao_ui_message_t*)pevent;
+#else
+	ao_ui_message_t* pmsg = *(ao_ui_message_t**)pevent;
+#endif
+	latency_stamp(&pmsg->stamp, LATENCY_HOP_UI_DISPATCH);
+
+	// 1) Evento -> próximo estado
+	ui_state_t next_state = current_state;
+	switch (pmsg->action) {
+	case MSG_EVENT_BUTTON_PULSE:
+		next_state = UI_STATE_RED;
+		break;
+	case MSG_EVENT_BUTTON_SHORT:
+		next_state = UI_STATE_GREEN;
+		break;
+	case MSG_EVENT_BUTTON_LONG:
+		next_state = UI_STATE_BLUE;
+		break;
+	default:
+		break;
+	}
+
+	// 2) Si cambio el estado: apagar el LED del estado actual
+	if (next_state != current_state)
+	{
+		// El ON del nuevo estado cierra el camino; el OFF solo si no hay ON
+		const latency_stamp_t* poff_stamp = (UI_STATE_STANDBY == next_state) ? &pmsg->stamp : NULL;
+
+		switch (current_state)
+		{
+		case UI_STATE_STANDBY:
+			break;
+		case UI_STATE_RED:
+		case UI_STATE_GREEN:
+		case UI_STATE_BLUE:
+			ui_send_led_(  (current_state == UI_STATE_RED)   ? &hao_led[AO_LED_COLOR_RED]:
+					(current_state == UI_STATE_GREEN) ? &hao_led[AO_LED_COLOR_GREEN]:
+							&hao_led[AO_LED_COLOR_BLUE], AO_LED_MESSAGE_OFF, poff_stamp);
+			break;
+		default:
+			break;
 		}
 
-		else	// Si luego de un tiempo UI_IDLE_TIMEOUT_MS_ no recibo eventos, elimino las colas y la tarea.
+		// 3) Encender el LED del nuevo estado
+		switch (next_state)
 		{
-			for(uint8_t i = 0; i < AO_LED_COLOR__N; i++) queue_led_delete(&hao_led[i]);	// Elimino cola de LEDs
-			queue_ui_delete();															// Elimino cola de ui
-			LOGGER_INFO("Eliminando tarea UI");
-			vTaskDelete(NULL);															// Elimino tarea
+		case UI_STATE_STANDBY:
+			break;
+		case UI_STATE_RED:
+		case UI_STATE_GREEN:
+		case UI_STATE_BLUE:
+			ui_send_led_(	(next_state == UI_STATE_RED)   ? &hao_led[AO_LED_COLOR_RED]   :
+					(next_state == UI_STATE_GREEN) ? &hao_led[AO_LED_COLOR_GREEN] :
+							&hao_led[AO_LED_COLOR_BLUE], AO_LED_MESSAGE_ON, &pmsg->stamp);
+			break;
+
+		default:
+			break;
 		}
+
+		// 4) Transicionar
+		current_state = next_state;
+	}
+
+	// 5) Liberar memoria del mensaje
+	if(pmsg->callback)
+	{
+		pmsg->callback(pmsg);
 	}
+
+	PROFILER_END(PROFILER_PROBE_AO_UI);
 }
 
 /********************** external functions definition ************************/
 
-bool ao_ui_send_event(ao_ui_message_t *pmsg)
+void ao_ui_init(void)
 {
-	if(NULL == hao_ui.hqueue)
-	{
-		LOGGER_INFO("Creando cola de UI");
-		hao_ui.hqueue = xQueueCreate(QUEUE_LENGTH_, QUEUE_ITEM_SIZE_);
-		if (NULL == hao_ui.hqueue)
-		{
-			LOGGER_INFO("Error creando cola de UI");
-			// error
-			return false;
-		}
+#if (0 == AO_LED_CONFIG_BY_VALUE)
+	MEMORY_POOL_INIT(&led_message_pool_, led_message_storage_);
+#endif
+	ao_init(&hao_ui, &ao_ui_config_);
+}
 
-		LOGGER_INFO("Creando tarea de UI");
-		BaseType_t status;
-		status = xTaskCreate(task_ui, "task_ui", 128, NULL, tskIDLE_PRIORITY, NULL);
-		if (pdPASS != status)
-		{
-			LOGGER_INFO("Error creando tarea de UI");
-			// error
-			vQueueDelete(hao_ui.hqueue);
-			hao_ui.hqueue = NULL;
-			return false;
-		}
-	}
-	return (pdPASS == xQueueSend(hao_ui.hqueue, (void*)&pmsg, 0));
+bool ao_ui_send_event(ao_ui_message_t *pmsg)
+{
+#if (1 == AO_UI_CONFIG_BY_VALUE)
+	return ao_send(&hao_ui, pmsg);
+#else
+	return ao_send(&hao_ui, &pmsg);
+#endif
 }
 
-static void queue_ui_delete(void)
+void ao_ui_get_stats(ao_ui_stats_t* pstats)
 {
-	if(NULL != hao_ui.hqueue)
-	{
-		LOGGER_INFO("Eliminando cola de UI");
-		ao_ui_message_t *pmsg;
-
-		// Exclusión mutua para evitar que se ingresen mensajes cuando se esta destruyendo el recurso
-		taskENTER_CRITICAL();{
-			while(pdPASS == xQueueReceive(hao_ui.hqueue, (void*)&pmsg, 0))
-			{
-				LOGGER_INFO("Liberando memoria de %s de la cola UI", button_action_name[pmsg->action]);
-				vPortFree(pmsg);
-			}
-		}taskEXIT_CRITICAL();
-
-		LOGGER_INFO("Cola UI eliminada");
-		vQueueDelete(hao_ui.hqueue);
-		hao_ui.hqueue = NULL;
-	}
+	ao_get_stats(&hao_ui, &pstats->ao);
+#if (0 == AO_LED_CONFIG_BY_VALUE)
+	pstats->led_pool_exhausted = led_message_pool_.exhausted;
+#else
+	pstats->led_pool_exhausted = 0;
+#endif
 }
+
+/********************** end of file ******************************************/
@@ -44,14 +44,26 @@
 /* Demo includes. */
 #include "logger.h"
 #include "dwt.h"
+#include "timebase.h"
 
 /* Application & Tasks includes. */
 #include "board.h"
 
 #include "task_button.h"
+#include "ao_timer.h"
+#include "ao_ui.h"
+#include "ao_led.h"
+#include "bench.h"
+#include "cpu_stats.h"
+#include "mem_stats.h"
+#include "trace.h"
+#include "profiler.h"
+#include "critical.h"
+#include "latency.h"
 
 /********************** macros and definitions *******************************/
 
+#define LOGGER_MODULE            APP
 
 /********************** internal data declaration ****************************/
 
@@ -66,15 +78,34 @@ void app_init(void)
 {
   BaseType_t status;
 
+  timebase_init();
+  cycle_counter_init();
+  trace_init();
+  profiler_init();
+  critical_init();
+  latency_init();
+  logger_init();
+  cpu_stats_init();
+  mem_stats_init();
+  ao_timer_service_init();
+  ao_led_init();
+  ao_ui_init();
+
   status = xTaskCreate(task_button, "task_button", 128, NULL, tskIDLE_PRIORITY, NULL);
   while (pdPASS != status)
   {
     // error
   }
 
-  LOGGER_INFO("app init");
+#if 1 == BENCH_CONFIG_ENABLE
+  status = xTaskCreate(task_bench, "task_bench", BENCH_CONFIG_TASK_STACK_SIZE, NULL, BENCH_CONFIG_TASK_PRIORITY, NULL);
+  while (pdPASS != status)
+  {
+    // error
+  }
+#endif
 
-  cycle_counter_init();
+  LOGGER_INFO("app init");
 }
 
 /********************** end of file ******************************************/
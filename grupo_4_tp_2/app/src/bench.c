@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : bench.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+#include "memory_pool.h"
+#include "heap_tlsf.h"
+
+#include "ao_ui.h"
+#include "ao_led.h"
+#include "bench.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+#if (1 == HEAP_TLSF_CONFIG_ENABLE)
+#define HEAP_NAME_               "tlsf"
+#else
+#define HEAP_NAME_               "heap_4"
+#endif
+
+#define HEAP_HOLES_              (16)
+#define HEAP_HOLE_SIZE_          (1)     // bloque minimo
+#define HEAP_BIG_SIZE_           (32)    // no entra en ningun hueco
+
+typedef enum
+{
+    ROUND_TRIP_HEAP_,       // original: pvPortMalloc + callback con vPortFree
+    ROUND_TRIP_POOL_,       // puntero a bloque de pool + callback
+    ROUND_TRIP_VALUE_,      // copia del mensaje en la cola
+} round_trip_mode_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+MEMORY_POOL_STORAGE(bench_pool_storage_, ao_led_message_t, 4);
+static memory_pool_t bench_pool_;
+
+MEMORY_POOL_STORAGE(bench_ui_pool_storage_, ao_ui_message_t, 1);
+static memory_pool_t bench_ui_pool_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+static void bench_heap_(const char* name_get, const char* name_put, size_t size)
+{
+    bench_stats_t get, put;
+    bench_stats_reset(&get, name_get);
+    bench_stats_reset(&put, name_put);
+
+    for (uint32_t i = 0; i < BENCH_CONFIG_ITERATIONS; i++)
+    {
+        uint32_t t0 = cycle_counter_get();
+        void* p = pvPortMalloc(size);
+        uint32_t t1 = cycle_counter_get();
+        vPortFree(p);
+        uint32_t t2 = cycle_counter_get();
+        if (NULL != p)
+        {
+            bench_stats_add(&get, t1 - t0);
+            bench_stats_add(&put, t2 - t1);
+        }
+        else
+        {
+            bench_stats_fail(&get);
+        }
+    }
+
+    bench_stats_report(&get);
+    bench_stats_report(&put);
+}
+
+/* Pool de bloques fijos vs el heap (pvPortMalloc/vPortFree), con el heap
+ * limpio y con huecos chicos: heap_4 los recorre en la lista libre, TLSF no */
+static void bench_memory_pool_(void)
+{
+    bench_stats_t get, put;
+    bench_stats_reset(&get, "pool get");
+    bench_stats_reset(&put, "pool put");
+
+    MEMORY_POOL_INIT(&bench_pool_, bench_pool_storage_);
+    for (uint32_t i = 0; i < BENCH_CONFIG_ITERATIONS; i++)
+    {
+        uint32_t t0 = cycle_counter_get();
+        void* p = memory_pool_block_get(&bench_pool_);
+        uint32_t t1 = cycle_counter_get();
+        if (NULL == p)
+        {
+            bench_stats_fail(&get);
+            continue;
+        }
+        memory_pool_block_put(&bench_pool_, p);
+        uint32_t t2 = cycle_counter_get();
+        bench_stats_add(&get, t1 - t0);
+        bench_stats_add(&put, t2 - t1);
+    }
+    bench_stats_report(&get);
+    bench_stats_report(&put);
+
+    bench_heap_(HEAP_NAME_ " malloc", HEAP_NAME_ " free", sizeof(ao_led_message_t));
+
+    void* blocks[2 * HEAP_HOLES_];
+    for (uint32_t i = 0; i < (2 * HEAP_HOLES_); i++)
+    {
+        blocks[i] = pvPortMalloc(HEAP_HOLE_SIZE_);
+    }
+    for (uint32_t i = 0; i < (2 * HEAP_HOLES_); i += 2)
+    {
+        vPortFree(blocks[i]);
+    }
+
+    bench_heap_(HEAP_NAME_ " frag malloc", HEAP_NAME_ " frag free", HEAP_BIG_SIZE_);
+
+    for (uint32_t i = 1; i < (2 * HEAP_HOLES_); i += 2)
+    {
+        vPortFree(blocks[i]);
+    }
+}
+
+static void bench_heap_free_cb_(void* pmsg)
+{
+    vPortFree(pmsg);
+}
+
+static void bench_ui_pool_free_cb_(void* pmsg)
+{
+    memory_pool_block_put(&bench_ui_pool_, pmsg);
+}
+
+static void bench_led_pool_free_cb_(void* pmsg)
+{
+    memory_pool_block_put(&bench_pool_, pmsg);
+}
+
+/* false si no hubo memoria o la cola estaba llena; el mensaje no se pierde */
+static bool bench_led_send_(QueueHandle_t hqueue, round_trip_mode_t mode, ao_led_action_t action)
+{
+    ao_led_message_t msg = {.callback = NULL, .action = action, .payload = NULL};
+    ao_led_message_t* pmsg = &msg;
+
+    if (ROUND_TRIP_VALUE_ == mode)
+    {
+        return pdPASS == xQueueSend(hqueue, &msg, 0);
+    }
+
+    if (ROUND_TRIP_HEAP_ == mode)
+    {
+        pmsg = (ao_led_message_t*)pvPortMalloc(sizeof(ao_led_message_t));
+        if (NULL == pmsg)
+        {
+            return false;
+        }
+        pmsg->callback = bench_heap_free_cb_;
+    }
+    else
+    {
+        pmsg = MEMORY_POOL_GET(&bench_pool_, ao_led_message_t);
+        if (NULL == pmsg)
+        {
+            return false;
+        }
+        pmsg->callback = bench_led_pool_free_cb_;
+    }
+    pmsg->action = action;
+    pmsg->payload = NULL;
+    if (pdPASS != xQueueSend(hqueue, &pmsg, 0))
+    {
+        pmsg->callback(pmsg);
+        return false;
+    }
+    return true;
+}
+
+static void bench_led_process_(QueueHandle_t hqueue, round_trip_mode_t mode)
+{
+    ao_led_message_t msg;
+    ao_led_message_t* pmsg = &msg;
+    void* pitem = (ROUND_TRIP_VALUE_ == mode) ? (void*)&msg : (void*)&pmsg;
+
+    if ((pdPASS == xQueueReceive(hqueue, pitem, 0)) && (NULL != pmsg->callback))
+    {
+        pmsg->callback(pmsg);
+    }
+}
+
+/* Recorrido boton -> UI -> LED de una transicion (un evento de UI, un OFF y un
+ * ON al LED) con las mismas colas y el mismo tamano de mensaje que los AO, en
+ * los tres modos de mensajeria. Se mide en una sola tarea para contar solo el
+ * costo de la mensajeria, sin cambios de contexto */
+static void bench_round_trip_(const char* name, round_trip_mode_t mode)
+{
+    size_t ui_item = (ROUND_TRIP_VALUE_ == mode) ? sizeof(ao_ui_message_t) : sizeof(ao_ui_message_t*);
+    size_t led_item = (ROUND_TRIP_VALUE_ == mode) ? sizeof(ao_led_message_t) : sizeof(ao_led_message_t*);
+    QueueHandle_t hqueue_ui = xQueueCreate(AO_UI_QUEUE_LENGTH, ui_item);
+    QueueHandle_t hqueue_led = xQueueCreate(AO_LED_QUEUE_LENGTH, led_item);
+    if ((NULL == hqueue_ui) || (NULL == hqueue_led))
+    {
+        LOGGER_ERROR("%s: sin memoria para las colas", name);
+        if (NULL != hqueue_ui)
+        {
+            vQueueDelete(hqueue_ui);
+        }
+        if (NULL != hqueue_led)
+        {
+            vQueueDelete(hqueue_led);
+        }
+        return;
+    }
+
+    bench_stats_t stats;
+    bench_stats_reset(&stats, name);
+
+    for (uint32_t i = 0; i < BENCH_CONFIG_ITERATIONS; i++)
+    {
+        uint32_t t0 = cycle_counter_get();
+
+        // task_button
+        ao_ui_message_t ui_msg = {.callback = NULL, .action = MSG_EVENT_BUTTON_PULSE, .payload = NULL};
+        ao_ui_message_t* pui_msg = &ui_msg;
+        bool ok;
+        if (ROUND_TRIP_VALUE_ == mode)
+        {
+            ok = (pdPASS == xQueueSend(hqueue_ui, &ui_msg, 0));
+        }
+        else
+        {
+            if (ROUND_TRIP_HEAP_ == mode)
+            {
+                pui_msg = (ao_ui_message_t*)pvPortMalloc(sizeof(ao_ui_message_t));
+                if (NULL != pui_msg)
+                {
+                    pui_msg->callback = bench_heap_free_cb_;
+                }
+            }
+            else
+            {
+                pui_msg = MEMORY_POOL_GET(&bench_ui_pool_, ao_ui_message_t);
+                if (NULL != pui_msg)
+                {
+                    pui_msg->callback = bench_ui_pool_free_cb_;
+                }
+            }
+            ok = (NULL != pui_msg);
+            if (ok)
+            {
+                pui_msg->action = MSG_EVENT_BUTTON_PULSE;
+                pui_msg->payload = NULL;
+                ok = (pdPASS == xQueueSend(hqueue_ui, &pui_msg, 0));
+                if (!ok)
+                {
+                    pui_msg->callback(pui_msg);
+                }
+            }
+        }
+        if (!ok)
+        {
+            bench_stats_fail(&stats);
+            continue;
+        }
+
+        // task_ui
+        void* pitem = (ROUND_TRIP_VALUE_ == mode) ? (void*)&ui_msg : (void*)&pui_msg;
+        (void)xQueueReceive(hqueue_ui, pitem, 0);
+        ok = bench_led_send_(hqueue_led, mode, AO_LED_MESSAGE_OFF);
+        ok = bench_led_send_(hqueue_led, mode, AO_LED_MESSAGE_ON) && ok;
+
+        // dispatch de ao_led: solo lo que llego a la cola
+        bench_led_process_(hqueue_led, mode);
+        bench_led_process_(hqueue_led, mode);
+
+        if (NULL != pui_msg->callback)
+        {
+            pui_msg->callback(pui_msg);
+        }
+
+        uint32_t t1 = cycle_counter_get();
+        if (ok)
+        {
+            bench_stats_add(&stats, t1 - t0);
+        }
+        else
+        {
+            bench_stats_fail(&stats);
+        }
+    }
+
+    vQueueDelete(hqueue_ui);
+    vQueueDelete(hqueue_led);
+    bench_stats_report(&stats);
+}
+
+static void bench_messaging_(void)
+{
+    MEMORY_POOL_INIT(&bench_pool_, bench_pool_storage_);
+    MEMORY_POOL_INIT(&bench_ui_pool_, bench_ui_pool_storage_);
+
+    bench_round_trip_("round trip heap", ROUND_TRIP_HEAP_);
+    bench_round_trip_("round trip pool", ROUND_TRIP_POOL_);
+    bench_round_trip_("round trip value", ROUND_TRIP_VALUE_);
+}
+
+/********************** external functions definition ************************/
+
+void bench_stats_reset(bench_stats_t* pstats, const char* name)
+{
+    pstats->name = name;
+    pstats->count = 0;
+    pstats->min = UINT32_MAX;
+    pstats->max = 0;
+    pstats->sum = 0;
+    pstats->failed = 0;
+}
+
+void bench_stats_add(bench_stats_t* pstats, uint32_t cycles)
+{
+    pstats->count++;
+    pstats->sum += cycles;
+    if (cycles < pstats->min)
+    {
+        pstats->min = cycles;
+    }
+    if (cycles > pstats->max)
+    {
+        pstats->max = cycles;
+    }
+}
+
+void bench_stats_fail(bench_stats_t* pstats)
+{
+    pstats->failed++;
+}
+
+void bench_stats_report(const bench_stats_t* pstats)
+{
+    if (0 < pstats->failed)
+    {
+        LOGGER_WARN("%s: %lu fallos (sin memoria o cola llena)", pstats->name, pstats->failed);
+    }
+    if (0 == pstats->count)
+    {
+        LOGGER_INFO("%s: sin muestras", pstats->name);
+        return;
+    }
+
+    uint32_t mean = (uint32_t)(pstats->sum / pstats->count);
+    LOGGER_INFO("%s: n=%lu min=%lu max=%lu", pstats->name, pstats->count, pstats->min, pstats->max);
+    LOGGER_INFO("%s: mean=%lu jitter=%lu", pstats->name, mean, pstats->max - pstats->min);
+    vTaskDelay(pdMS_TO_TICKS(BENCH_CONFIG_REPORT_DELAY_MS));
+}
+
+void bench_run(void)
+{
+    LOGGER_INFO("bench: inicio (ciclos DWT)");
+
+    bench_memory_pool_();
+    bench_messaging_();
+    bench_rtos();
+
+    LOGGER_INFO("bench: fin");
+}
+
+void task_bench(void* argument)
+{
+    bench_run();
+    vTaskDelete(NULL);
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : bench_rtos.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Micro-benchmarks de los objetos del kernel, en ciclos DWT.
+ *
+ * Dos grupos:
+ * - costo de la llamada: envio y recepcion en la misma tarea, sin bloqueo ni
+ *   cambio de contexto (el piso de cada primitiva)
+ * - despertar: una tarea de prioridad mayor espera en la primitiva y
+ *   task_bench le envia; se mide desde antes del envio hasta que la otra
+ *   tarea retoma, con el cambio de contexto incluido (el camino de los AO)
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+#include "event_groups.h"
+
+#include "ao_ui.h"
+#include "bench.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+#define WAKE_TASK_PRIORITY_      (BENCH_CONFIG_TASK_PRIORITY + 1)
+#define WAKE_TASK_STACK_SIZE_    (128)
+#define CHURN_TASK_STACK_SIZE_   (128)
+#define COUNTING_MAX_            (4)
+#define EVENT_BIT_               (1UL << 0)
+
+// Mensaje por valor: el de ao_ui, el mas grande de los AO
+typedef ao_ui_message_t bench_item_t;
+
+typedef enum
+{
+    WAKE_NOTIFY_,
+    WAKE_SEMAPHORE_,
+    WAKE_QUEUE_POINTER_,
+    WAKE_QUEUE_VALUE_,
+    WAKE_STREAM_BUFFER_,
+    WAKE_MESSAGE_BUFFER_,
+    WAKE_EVENT_GROUP_,
+    WAKE__N_,
+} wake_kind_t;
+
+/********************** internal data declaration ****************************/
+
+typedef struct
+{
+    const char* name_send;
+    const char* name_receive;
+    bool (*create)(void);
+    void (*send)(void);
+    void (*receive)(void);
+    void (*destroy)(void);
+} call_bench_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static QueueHandle_t hqueue_;
+static SemaphoreHandle_t hsemaphore_;
+static StreamBufferHandle_t hstream_;
+static EventGroupHandle_t hevent_;
+static TaskHandle_t htask_;
+
+static bench_item_t item_;
+static void* pointer_ = &item_;
+
+static volatile uint32_t wake_t0_;
+static bench_stats_t wake_stats_;
+
+static const char* const wake_names_[WAKE__N_] = {
+    "wake notify",
+    "wake binary sem",
+    "wake queue ptr",
+    "wake queue value",
+    "wake stream buffer",
+    "wake message buffer",
+    "wake event group",
+};
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Costo de la llamada *******************************************************/
+
+static bool queue_pointer_create_(void)
+{
+    hqueue_ = xQueueCreate(1, sizeof(void*));
+    return NULL != hqueue_;
+}
+
+static bool queue_value_create_(void)
+{
+    hqueue_ = xQueueCreate(1, sizeof(bench_item_t));
+    return NULL != hqueue_;
+}
+
+static void queue_pointer_send_(void)
+{
+    (void)xQueueSend(hqueue_, &pointer_, 0);
+}
+
+static void queue_pointer_receive_(void)
+{
+    void* p;
+    (void)xQueueReceive(hqueue_, &p, 0);
+}
+
+static void queue_value_send_(void)
+{
+    (void)xQueueSend(hqueue_, &item_, 0);
+}
+
+static void queue_value_receive_(void)
+{
+    bench_item_t item;
+    (void)xQueueReceive(hqueue_, &item, 0);
+}
+
+static void queue_destroy_(void)
+{
+    vQueueDelete(hqueue_);
+}
+
+static bool notify_create_(void)
+{
+    htask_ = xTaskGetCurrentTaskHandle();
+    return true;
+}
+
+static void notify_give_(void)
+{
+    (void)xTaskNotifyGive(htask_);
+}
+
+static void notify_take_(void)
+{
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+}
+
+static void notify_set_(void)
+{
+    (void)xTaskNotify(htask_, (uint32_t)MSG_EVENT_BUTTON_PULSE, eSetValueWithOverwrite);
+}
+
+static void notify_wait_(void)
+{
+    uint32_t value;
+    (void)xTaskNotifyWait(0, UINT32_MAX, &value, 0);
+}
+
+static void notify_destroy_(void)
+{
+}
+
+static bool binary_create_(void)
+{
+    hsemaphore_ = xSemaphoreCreateBinary();
+    return NULL != hsemaphore_;
+}
+
+static bool counting_create_(void)
+{
+    hsemaphore_ = xSemaphoreCreateCounting(COUNTING_MAX_, 0);
+    return NULL != hsemaphore_;
+}
+
+static bool mutex_create_(void)
+{
+    hsemaphore_ = xSemaphoreCreateMutex();
+    return NULL != hsemaphore_;
+}
+
+static void semaphore_give_(void)
+{
+    (void)xSemaphoreGive(hsemaphore_);
+}
+
+static void semaphore_take_(void)
+{
+    (void)xSemaphoreTake(hsemaphore_, 0);
+}
+
+static void semaphore_destroy_(void)
+{
+    vSemaphoreDelete(hsemaphore_);
+}
+
+static bool stream_create_(void)
+{
+    hstream_ = xStreamBufferCreate(sizeof(void*), 1);
+    return NULL != hstream_;
+}
+
+static bool message_create_(void)
+{
+    hstream_ = xMessageBufferCreate(sizeof(bench_item_t) + sizeof(configMESSAGE_BUFFER_LENGTH_TYPE));
+    return NULL != hstream_;
+}
+
+static void stream_send_(void)
+{
+    (void)xStreamBufferSend(hstream_, &pointer_, sizeof(pointer_), 0);
+}
+
+static void stream_receive_(void)
+{
+    void* p;
+    (void)xStreamBufferReceive(hstream_, &p, sizeof(p), 0);
+}
+
+static void message_send_(void)
+{
+    (void)xMessageBufferSend(hstream_, &item_, sizeof(item_), 0);
+}
+
+static void message_receive_(void)
+{
+    bench_item_t item;
+    (void)xMessageBufferReceive(hstream_, &item, sizeof(item), 0);
+}
+
+static void stream_destroy_(void)
+{
+    vStreamBufferDelete(hstream_);
+}
+
+static bool event_create_(void)
+{
+    hevent_ = xEventGroupCreate();
+    return NULL != hevent_;
+}
+
+static void event_set_(void)
+{
+    (void)xEventGroupSetBits(hevent_, EVENT_BIT_);
+}
+
+static void event_wait_(void)
+{
+    (void)xEventGroupWaitBits(hevent_, EVENT_BIT_, pdTRUE, pdFALSE, 0);
+}
+
+static void event_destroy_(void)
+{
+    vEventGroupDelete(hevent_);
+}
+
+static const call_bench_t call_benches_[] = {
+    {"queue ptr send",       "queue ptr recv",       queue_pointer_create_, queue_pointer_send_, queue_pointer_receive_, queue_destroy_},
+    {"queue value send",     "queue value recv",     queue_value_create_,   queue_value_send_,   queue_value_receive_,   queue_destroy_},
+    {"notify give",          "notify take",          notify_create_,        notify_give_,        notify_take_,           notify_destroy_},
+    {"notify set",           "notify wait",          notify_create_,        notify_set_,         notify_wait_,           notify_destroy_},
+    {"binary sem give",      "binary sem take",      binary_create_,        semaphore_give_,     semaphore_take_,        semaphore_destroy_},
+    {"counting sem give",    "counting sem take",    counting_create_,      semaphore_give_,     semaphore_take_,        semaphore_destroy_},
+    {"mutex give",           "mutex take",           mutex_create_,         semaphore_give_,     semaphore_take_,        semaphore_destroy_},
+    {"stream buffer send",   "stream buffer recv",   stream_create_,        stream_send_,        stream_receive_,        stream_destroy_},
+    {"message buffer send",  "message buffer recv",  message_create_,       message_send_,       message_receive_,       stream_destroy_},
+    {"event group set",      "event group wait",     event_create_,         event_set_,          event_wait_,            event_destroy_},
+};
+
+static void bench_call_(const call_bench_t* pbench)
+{
+    if (!pbench->create())
+    {
+        LOGGER_ERROR("%s: sin memoria", pbench->name_send);
+        return;
+    }
+
+    bench_stats_t send, receive;
+    bench_stats_reset(&send, pbench->name_send);
+    bench_stats_reset(&receive, pbench->name_receive);
+
+    // El mutex se crea tomado por nadie: se empieza por take
+    bool take_first = (mutex_create_ == pbench->create);
+    for (uint32_t i = 0; i < BENCH_CONFIG_ITERATIONS; i++)
+    {
+        uint32_t t0 = cycle_counter_get();
+        if (take_first)
+        {
+            pbench->receive();
+        }
+        else
+        {
+            pbench->send();
+        }
+        uint32_t t1 = cycle_counter_get();
+        if (take_first)
+        {
+            pbench->send();
+        }
+        else
+        {
+            pbench->receive();
+        }
+        uint32_t t2 = cycle_counter_get();
+        bench_stats_add(take_first ? &receive : &send, t1 - t0);
+        bench_stats_add(take_first ? &send : &receive, t2 - t1);
+    }
+
+    pbench->destroy();
+    bench_stats_report(&send);
+    bench_stats_report(&receive);
+}
+
+/* xTaskCreate/vTaskDelete de una tarea de menor prioridad, que nunca llega a
+ * correr: vTaskDelete de otra tarea libera TCB y stack en el momento */
+static void task_churn_(void* argument)
+{
+    for (;;)
+    {
+    }
+}
+
+static void bench_task_churn_(void)
+{
+    bench_stats_t create, destroy;
+    bench_stats_reset(&create, "task create");
+    bench_stats_reset(&destroy, "task delete");
+
+    for (uint32_t i = 0; i < BENCH_CONFIG_ITERATIONS; i++)
+    {
+        TaskHandle_t htask;
+        uint32_t t0 = cycle_counter_get();
+        BaseType_t status = xTaskCreate(task_churn_, "task_churn", CHURN_TASK_STACK_SIZE_, NULL, tskIDLE_PRIORITY, &htask);
+        uint32_t t1 = cycle_counter_get();
+        if (pdPASS != status)
+        {
+            LOGGER_ERROR("task create: sin memoria");
+            break;
+        }
+        vTaskDelete(htask);
+        uint32_t t2 = cycle_counter_get();
+        bench_stats_add(&create, t1 - t0);
+        bench_stats_add(&destroy, t2 - t1);
+    }
+
+    bench_stats_report(&create);
+    bench_stats_report(&destroy);
+}
+
+/* Despertar ****************************************************************/
+
+static void task_wake_(void* argument)
+{
+    wake_kind_t kind = (wake_kind_t)(uintptr_t)argument;
+    bench_item_t item;
+    void* p;
+
+    for (;;)
+    {
+        switch (kind)
+        {
+            case WAKE_NOTIFY_:
+                (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                break;
+            case WAKE_SEMAPHORE_:
+                (void)xSemaphoreTake(hsemaphore_, portMAX_DELAY);
+                break;
+            case WAKE_QUEUE_POINTER_:
+                (void)xQueueReceive(hqueue_, &p, portMAX_DELAY);
+                break;
+            case WAKE_QUEUE_VALUE_:
+                (void)xQueueReceive(hqueue_, &item, portMAX_DELAY);
+                break;
+            case WAKE_STREAM_BUFFER_:
+                (void)xStreamBufferReceive(hstream_, &p, sizeof(p), portMAX_DELAY);
+                break;
+            case WAKE_MESSAGE_BUFFER_:
+                (void)xMessageBufferReceive(hstream_, &item, sizeof(item), portMAX_DELAY);
+                break;
+            case WAKE_EVENT_GROUP_:
+            default:
+                (void)xEventGroupWaitBits(hevent_, EVENT_BIT_, pdTRUE, pdFALSE, portMAX_DELAY);
+                break;
+        }
+        bench_stats_add(&wake_stats_, cycle_counter_elapsed(wake_t0_));
+    }
+}
+
+static bool wake_create_(wake_kind_t kind)
+{
+    switch (kind)
+    {
+        case WAKE_NOTIFY_:
+            return true;
+        case WAKE_SEMAPHORE_:
+            return binary_create_();
+        case WAKE_QUEUE_POINTER_:
+            return queue_pointer_create_();
+        case WAKE_QUEUE_VALUE_:
+            return queue_value_create_();
+        case WAKE_STREAM_BUFFER_:
+            return stream_create_();
+        case WAKE_MESSAGE_BUFFER_:
+            return message_create_();
+        case WAKE_EVENT_GROUP_:
+        default:
+            return event_create_();
+    }
+}
+
+static void wake_send_(wake_kind_t kind)
+{
+    switch (kind)
+    {
+        case WAKE_NOTIFY_:
+            notify_give_();
+            break;
+        case WAKE_SEMAPHORE_:
+            semaphore_give_();
+            break;
+        case WAKE_QUEUE_POINTER_:
+            queue_pointer_send_();
+            break;
+        case WAKE_QUEUE_VALUE_:
+            queue_value_send_();
+            break;
+        case WAKE_STREAM_BUFFER_:
+            stream_send_();
+            break;
+        case WAKE_MESSAGE_BUFFER_:
+            message_send_();
+            break;
+        case WAKE_EVENT_GROUP_:
+        default:
+            event_set_();
+            break;
+    }
+}
+
+static void wake_destroy_(wake_kind_t kind)
+{
+    switch (kind)
+    {
+        case WAKE_NOTIFY_:
+            break;
+        case WAKE_SEMAPHORE_:
+            semaphore_destroy_();
+            break;
+        case WAKE_QUEUE_POINTER_:
+        case WAKE_QUEUE_VALUE_:
+            queue_destroy_();
+            break;
+        case WAKE_STREAM_BUFFER_:
+        case WAKE_MESSAGE_BUFFER_:
+            stream_destroy_();
+            break;
+        case WAKE_EVENT_GROUP_:
+        default:
+            event_destroy_();
+            break;
+    }
+}
+
+/* La tarea que espera tiene mas prioridad: el envio la despierta y desaloja
+ * a task_bench antes de volver, asi que cada envio cierra una muestra */
+static void bench_wake_(wake_kind_t kind)
+{
+    TaskHandle_t hwaiter = NULL;
+
+    bench_stats_reset(&wake_stats_, wake_names_[kind]);
+    if (!wake_create_(kind))
+    {
+        LOGGER_ERROR("%s: sin memoria", wake_names_[kind]);
+        return;
+    }
+    BaseType_t status = xTaskCreate(task_wake_, "task_wake", WAKE_TASK_STACK_SIZE_, (void*)(uintptr_t)kind, WAKE_TASK_PRIORITY_, &hwaiter);
+    if (pdPASS != status)
+    {
+        LOGGER_ERROR("%s: sin memoria", wake_names_[kind]);
+        wake_destroy_(kind);
+        return;
+    }
+    htask_ = hwaiter;
+
+    for (uint32_t i = 0; i < BENCH_CONFIG_ITERATIONS; i++)
+    {
+        wake_t0_ = cycle_counter_get();
+        wake_send_(kind);
+    }
+
+    // Borrar la tarea antes que el objeto en el que quedo bloqueada
+    vTaskDelete(hwaiter);
+    wake_destroy_(kind);
+    bench_stats_report(&wake_stats_);
+}
+
+/********************** external functions definition ************************/
+
+void bench_rtos(void)
+{
+    for (uint32_t i = 0; i < (sizeof(call_benches_) / sizeof(call_benches_[0])); i++)
+    {
+        bench_call_(&call_benches_[i]);
+    }
+    bench_task_churn_();
+
+    for (uint32_t kind = 0; kind < WAKE__N_; kind++)
+    {
+        bench_wake_((wake_kind_t)kind);
+    }
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : button_engine.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "button_engine.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/********************** external functions definition ************************/
+
+void button_engine_init(button_engine_t* pengine, uint32_t ticks_per_ms, uint32_t debounce_ms, bool pressed)
+{
+	pengine->ticks_per_ms = ticks_per_ms;
+	pengine->debounce_ticks = debounce_ms * ticks_per_ms;
+	pengine->pressed = pressed;
+	pengine->raw_pressed = pressed;
+	pengine->raw_time = 0;
+	pengine->press_time = 0;
+	pengine->release_time = 0;
+	pengine->edges = 0;
+	pengine->bounces = 0;
+}
+
+/* Registra un flanco. Se puede llamar desde la interrupcion del pin */
+void button_engine_edge(button_engine_t* pengine, uint32_t time, bool pressed)
+{
+	pengine->edges++;
+	if (pengine->raw_pressed != pengine->pressed)
+	{
+		// Habia un cambio sin confirmar: era rebote
+		pengine->bounces++;
+	}
+	pengine->raw_pressed = pressed;
+	pengine->raw_time = time;
+}
+
+/* Acepta el nivel crudo si estuvo estable debounce_ticks. Al soltar devuelve
+ * la clasificacion de la pulsacion, medida entre los flancos aceptados */
+button_type_t button_engine_poll(button_engine_t* pengine, uint32_t now)
+{
+	if (!button_engine_pending(pengine) || ((now - pengine->raw_time) < pengine->debounce_ticks))
+	{
+		return BUTTON_TYPE_NONE;
+	}
+
+	pengine->pressed = pengine->raw_pressed;
+	if (pengine->pressed)
+	{
+		pengine->press_time = pengine->raw_time;
+		return BUTTON_TYPE_NONE;
+	}
+
+	pengine->release_time = pengine->raw_time;
+	uint32_t duration_ms = (pengine->release_time - pengine->press_time) / pengine->ticks_per_ms;
+	return button_engine_classify(duration_ms);
+}
+
+bool button_engine_pending(const button_engine_t* pengine)
+{
+	return (pengine->raw_pressed != pengine->pressed);
+}
+
+button_type_t button_engine_classify(uint32_t duration_ms)
+{
+	if (BUTTON_ENGINE_LONG_MS <= duration_ms)
+	{
+		return BUTTON_TYPE_LONG;
+	}
+	if (BUTTON_ENGINE_SHORT_MS <= duration_ms)
+	{
+		return BUTTON_TYPE_SHORT;
+	}
+	if (BUTTON_ENGINE_PULSE_MS <= duration_ms)
+	{
+		return BUTTON_TYPE_PULSE;
+	}
+	return BUTTON_TYPE_NONE;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : cpu_stats.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "profiler.h"
+#include "critical.h"
+#include "latency.h"
+#include "tickless.h"
+
+#include "cpu_stats.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+typedef struct
+{
+    UBaseType_t number;
+    uint32_t counter;
+} cpu_stats_prev_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static TaskStatus_t status_[CPU_STATS_CONFIG_MAX_TASKS];
+static cpu_stats_prev_t prev_[CPU_STATS_CONFIG_MAX_TASKS];
+static uint32_t prev_count_;
+static uint32_t prev_total_;
+
+static cpu_stats_snapshot_t snapshot_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Contador de la ventana anterior; una tarea nueva arranca de cero */
+static uint32_t cpu_stats_prev_counter_(UBaseType_t number)
+{
+    for (uint32_t i = 0; i < prev_count_; i++)
+    {
+        if (prev_[i].number == number)
+        {
+            return prev_[i].counter;
+        }
+    }
+    return 0;
+}
+
+static uint32_t cpu_stats_load_x100_(uint32_t run, uint32_t window)
+{
+    return (0 == window) ? 0 : (uint32_t)(((uint64_t)run * 10000) / window);
+}
+
+/********************** external functions definition ************************/
+
+void cpu_stats_init(void)
+{
+    prev_count_ = 0;
+    prev_total_ = 0;
+
+#if 1 == CPU_STATS_CONFIG_ENABLE
+    BaseType_t status;
+    status = xTaskCreate(task_cpu_stats, "task_cpu_stats", CPU_STATS_CONFIG_TASK_STACK_SIZE, NULL, CPU_STATS_CONFIG_TASK_PRIORITY, NULL);
+    while (pdPASS != status)
+    {
+        // error
+    }
+#endif
+}
+
+/* Ciclos y carga de cada tarea desde la llamada anterior. Hay un solo estado
+ * previo: pensado para un unico consumidor (task_cpu_stats) */
+bool cpu_stats_snapshot(cpu_stats_snapshot_t* psnapshot)
+{
+    uint32_t total;
+    UBaseType_t count = uxTaskGetSystemState(status_, CPU_STATS_CONFIG_MAX_TASKS, &total);
+    if (0 == count)
+    {
+        // Hay mas tareas que CPU_STATS_CONFIG_MAX_TASKS
+        return false;
+    }
+
+    TaskHandle_t hidle = xTaskGetIdleTaskHandle();
+    psnapshot->window_us = total - prev_total_;
+    psnapshot->idle_x100 = 0;
+    psnapshot->count = count;
+
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        cpu_stats_task_t* ptask = &psnapshot->task[i];
+        uint32_t run = status_[i].ulRunTimeCounter - cpu_stats_prev_counter_(status_[i].xTaskNumber);
+
+        strncpy(ptask->name, status_[i].pcTaskName, configMAX_TASK_NAME_LEN - 1);
+        ptask->name[configMAX_TASK_NAME_LEN - 1] = '\0';
+        ptask->number = status_[i].xTaskNumber;
+        ptask->run_us = run;
+        ptask->load_x100 = cpu_stats_load_x100_(run, psnapshot->window_us);
+        if (status_[i].xHandle == hidle)
+        {
+            psnapshot->idle_x100 = ptask->load_x100;
+        }
+    }
+
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        prev_[i].number = status_[i].xTaskNumber;
+        prev_[i].counter = status_[i].ulRunTimeCounter;
+    }
+    prev_count_ = count;
+    prev_total_ = total;
+
+    return true;
+}
+
+void cpu_stats_report(const cpu_stats_snapshot_t* psnapshot)
+{
+    LOGGER_INFO("cpu: ventana=%lu us idle=%lu.%02lu%%", psnapshot->window_us,
+                psnapshot->idle_x100 / 100, psnapshot->idle_x100 % 100);
+    for (uint32_t i = 0; i < psnapshot->count; i++)
+    {
+        const cpu_stats_task_t* ptask = &psnapshot->task[i];
+        // El modo diferido admite 4 argumentos: el numero de tarea no entra
+        LOGGER_INFO("cpu %s: %lu us %lu.%02lu%%", ptask->name,
+                    ptask->run_us, ptask->load_x100 / 100, ptask->load_x100 % 100);
+    }
+}
+
+void task_cpu_stats(void* argument)
+{
+    // Descarta la ventana desde el arranque del scheduler
+    (void)cpu_stats_snapshot(&snapshot_);
+
+    while (true)
+    {
+        // La ventana se mide con el timebase, la deriva del periodo no afecta
+        vTaskDelay(pdMS_TO_TICKS(CPU_STATS_CONFIG_REPORT_PERIOD_MS));
+        if (cpu_stats_snapshot(&snapshot_))
+        {
+            cpu_stats_report(&snapshot_);
+        }
+        else
+        {
+            LOGGER_WARN("cpu: mas de %d tareas", CPU_STATS_CONFIG_MAX_TASKS);
+        }
+
+#if 1 == PROFILER_CONFIG_ENABLE
+        // Se deja vaciar la cola del logger antes de la tabla del profiler
+        vTaskDelay(pdMS_TO_TICKS(LOGGER_CONFIG_TASK_PERIOD_MS));
+        profiler_report();
+#endif
+#if 1 == LATENCY_CONFIG_ENABLE
+        vTaskDelay(pdMS_TO_TICKS(LOGGER_CONFIG_TASK_PERIOD_MS));
+        latency_report();
+#endif
+#if 1 == CRITICAL_CONFIG_ENABLE
+        vTaskDelay(pdMS_TO_TICKS(LOGGER_CONFIG_TASK_PERIOD_MS));
+        critical_report();
+#endif
+#if 1 == TICKLESS_CONFIG_ENABLE
+        tickless_report();
+#endif
+    }
+}
+
+/********************** end of file ******************************************/
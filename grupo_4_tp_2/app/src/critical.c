@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : critical.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+#include "cpu_stats.h"
+
+#include "critical.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/* Marco de critical_report(): maximos y orden por punto mas una copia. Lo
+ * llama task_cpu_stats, se acota a un cuarto de su stack */
+#define CRITICAL_REPORT_FRAME_BYTES_    (CRITICAL_SITE__N * (sizeof(uint32_t) + sizeof(uint8_t)) + sizeof(critical_stats_t))
+
+_Static_assert(CRITICAL_REPORT_FRAME_BYTES_ <= (CPU_STATS_CONFIG_TASK_STACK_SIZE * sizeof(StackType_t)) / 4,
+               "critical_report() no entra en el stack de task_cpu_stats");
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static critical_stats_t sites_[CRITICAL_SITE__N];
+
+/********************** external data definition *****************************/
+
+const char* const critical_site_name[CRITICAL_SITE__N] =
+{
+    "logger_log",
+    "logger_record",
+    "logger_uart",
+    "logger_uart_isr",
+    "ao_send",
+    "ao_qv_ready",
+    "button_isr",
+    "button_poll",
+    "pool_get",
+    "pool_put",
+    "led_pwm_set",
+    "led_pwm_blink",
+    "led_pwm_fade",
+    "latency_record",
+    "latency_get",
+    "heap",
+};
+
+uint32_t critical_depth_;
+uint32_t critical_t0_;
+critical_site_t critical_site_;
+
+/********************** internal functions definition ************************/
+
+static inline uint32_t critical_bin_(uint32_t cycles)
+{
+    uint32_t bin = 32 - __CLZ(cycles);
+    return (bin < CRITICAL_CONFIG_HISTOGRAM_BINS) ? bin : (CRITICAL_CONFIG_HISTOGRAM_BINS - 1);
+}
+
+/* Bin que alcanza el percentil pedido; la cota superior es 2^bin ciclos */
+static uint32_t critical_percentile_bin_(const critical_stats_t* pstats, uint32_t percent)
+{
+    uint64_t target = ((uint64_t)pstats->count * percent + 99) / 100;
+    uint64_t acc = 0;
+    for (uint32_t bin = 0; bin < CRITICAL_CONFIG_HISTOGRAM_BINS; bin++)
+    {
+        acc += pstats->histogram[bin];
+        if (acc >= target)
+        {
+            return bin;
+        }
+    }
+    return CRITICAL_CONFIG_HISTOGRAM_BINS - 1;
+}
+
+/********************** external functions definition ************************/
+
+void critical_init(void)
+{
+    critical_depth_ = 0;
+    critical_reset();
+}
+
+/* Se llama al cerrar la seccion mas externa, todavia con las IRQ
+ * enmascaradas: no puede loguear (el logger usa secciones instrumentadas) */
+void critical_record_(critical_site_t site, uint32_t cycles)
+{
+    if (CRITICAL_SITE__N <= site)
+    {
+        return;
+    }
+
+    critical_stats_t* pstats = &sites_[site];
+    pstats->count++;
+    pstats->sum += cycles;
+    if (cycles > pstats->max)
+    {
+        pstats->max = cycles;
+    }
+    pstats->histogram[critical_bin_(cycles)]++;
+
+    if (CRITICAL_CONFIG_BUDGET_CYCLES < cycles)
+    {
+        pstats->over_budget++;
+#if 1 == CRITICAL_CONFIG_BUDGET_ASSERT
+        configASSERT(0);
+#endif
+    }
+}
+
+/* Copia consistente: la seccion de lectura no se instrumenta */
+bool critical_get(critical_site_t site, critical_stats_t* pstats)
+{
+    if (CRITICAL_SITE__N <= site)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *pstats = sites_[site];
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+void critical_reset(void)
+{
+    taskENTER_CRITICAL();
+    memset(sites_, 0, sizeof(sites_));
+    taskEXIT_CRITICAL();
+}
+
+/* Los CRITICAL_CONFIG_REPORT_TOP puntos con mayor maximo, dos lineas cada uno
+ * (el modo diferido admite 4 argumentos). Los que pasaron el presupuesto se
+ * informan como advertencia. Solo se ordenan los maximos; la copia completa
+ * de cada punto se toma al imprimirlo */
+void critical_report(void)
+{
+    uint32_t max[CRITICAL_SITE__N];
+    uint8_t order[CRITICAL_SITE__N];
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < CRITICAL_SITE__N; i++)
+    {
+        max[i] = sites_[i].max;
+        order[i] = (uint8_t)i;
+    }
+    taskEXIT_CRITICAL();
+
+    // Insercion por maximo descendente, son pocos puntos
+    for (uint32_t i = 1; i < CRITICAL_SITE__N; i++)
+    {
+        uint8_t site = order[i];
+        uint32_t j = i;
+        while ((0 < j) && (max[order[j - 1]] < max[site]))
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = site;
+    }
+
+    for (uint32_t i = 0; (i < CRITICAL_CONFIG_REPORT_TOP) && (i < CRITICAL_SITE__N); i++)
+    {
+        critical_stats_t stats;
+        const char* name = critical_site_name[order[i]];
+        if (!critical_get((critical_site_t)order[i], &stats) || (0 == stats.count))
+        {
+            break;
+        }
+        if (0 < stats.over_budget)
+        {
+            LOGGER_WARN("crit %s: max=%lu ciclos, %lu sobre %lu", name, stats.max,
+                        stats.over_budget, (uint32_t)CRITICAL_CONFIG_BUDGET_CYCLES);
+        }
+        else
+        {
+            LOGGER_INFO("crit %s: max=%lu ciclos", name, stats.max);
+        }
+        LOGGER_INFO("crit %s: n=%lu prom=%lu p99<2^%lu", name, stats.count,
+                    (uint32_t)(stats.sum / stats.count), critical_percentile_bin_(&stats, 99));
+    }
+}
+
+/********************** end of file ******************************************/
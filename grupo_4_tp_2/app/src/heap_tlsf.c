@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : heap_tlsf.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "critical.h"
+
+#include "tlsf.h"
+#include "heap_tlsf.h"
+
+#if (1 == HEAP_TLSF_CONFIG_ENABLE)
+
+#if (0 == configSUPPORT_DYNAMIC_ALLOCATION)
+#error heap_tlsf.c con configSUPPORT_DYNAMIC_ALLOCATION en 0
+#endif
+
+/********************** macros and definitions *******************************/
+
+// traceMALLOC/traceFREE reciben el bloque con su cabecera, como en heap_4
+#define TRACE_SIZE_(ptr)         (tlsf_block_size(ptr) + offsetof(tlsf_block_t, next_free))
+
+#if (1 == HEAP_TLSF_CONFIG_ISR_SAFE)
+#define HEAP_LOCK_()             CRITICAL_ENTER(CRITICAL_SITE_HEAP)
+#define HEAP_UNLOCK_()           CRITICAL_EXIT()
+#else
+#define HEAP_LOCK_()             vTaskSuspendAll()
+#define HEAP_UNLOCK_()           (void)xTaskResumeAll()
+#endif
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+#if (1 == configAPPLICATION_ALLOCATED_HEAP)
+extern uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+#else
+static uint8_t ucHeap[configTOTAL_HEAP_SIZE] __attribute__((aligned(TLSF_ALIGN)));
+#endif
+
+static tlsf_t heap_;
+static bool heap_ready_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Con el lock tomado. La primera llamada arma el heap, como prvHeapInit */
+static void* heap_malloc_(size_t size)
+{
+	if (!heap_ready_)
+	{
+		heap_ready_ = tlsf_init(&heap_, ucHeap, sizeof(ucHeap));
+		configASSERT(heap_ready_);
+	}
+	void* ptr = tlsf_malloc(&heap_, size);
+	traceMALLOC(ptr, (NULL == ptr) ? size : TRACE_SIZE_(ptr));
+	return ptr;
+}
+
+/* Como heap_4: un doble free o un puntero ajeno fallan aca y no corrompen
+ * las listas libres */
+static void heap_free_(void* ptr)
+{
+	configASSERT(tlsf_is_allocated(&heap_, ptr));
+	traceFREE(ptr, TRACE_SIZE_(ptr));
+	tlsf_free(&heap_, ptr);
+}
+
+/********************** external functions definition ************************/
+
+void* pvPortMalloc(size_t xWantedSize)
+{
+	void* ptr;
+
+	HEAP_LOCK_();
+	{
+		ptr = heap_malloc_(xWantedSize);
+	}
+	HEAP_UNLOCK_();
+
+#if (1 == configUSE_MALLOC_FAILED_HOOK)
+	if (NULL == ptr)
+	{
+		extern void vApplicationMallocFailedHook(void);
+		vApplicationMallocFailedHook();
+	}
+#endif
+
+	configASSERT(0 == ((uintptr_t)ptr & (TLSF_ALIGN - 1)));
+	return ptr;
+}
+
+void vPortFree(void* pv)
+{
+	if (NULL == pv)
+	{
+		return;
+	}
+
+	HEAP_LOCK_();
+	{
+		heap_free_(pv);
+	}
+	HEAP_UNLOCK_();
+}
+
+/* Antes del primer pvPortMalloc valen 0, como en heap_4 */
+size_t xPortGetFreeHeapSize(void)
+{
+	return heap_ready_ ? heap_.free : 0;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+	return heap_ready_ ? heap_.free_min : 0;
+}
+
+void vPortInitialiseBlocks(void)
+{
+	// Solo existe por compatibilidad, como en heap_4
+}
+
+void vPortGetHeapStats(HeapStats_t* pxHeapStats)
+{
+	tlsf_stats_t stats;
+
+	heap_tlsf_get_stats(&stats);
+	pxHeapStats->xAvailableHeapSpaceInBytes = stats.free;
+	// Lo que pvPortMalloc atiende: el redondeo de TLSF no llega al bloque crudo
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = stats.largest_alloc;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = stats.smallest_free;
+	pxHeapStats->xNumberOfFreeBlocks = stats.free_blocks;
+	pxHeapStats->xMinimumEverFreeBytesRemaining = stats.free_min;
+	pxHeapStats->xNumberOfSuccessfulAllocations = stats.allocs;
+	pxHeapStats->xNumberOfSuccessfulFrees = stats.frees;
+}
+
+void heap_tlsf_get_stats(tlsf_stats_t* pstats)
+{
+	HEAP_LOCK_();
+	{
+		if (!heap_ready_)
+		{
+			heap_ready_ = tlsf_init(&heap_, ucHeap, sizeof(ucHeap));
+		}
+		tlsf_get_stats(&heap_, pstats);
+	}
+	HEAP_UNLOCK_();
+}
+
+#if (1 == HEAP_TLSF_CONFIG_ISR_SAFE)
+
+/* Sin hook de malloc fallido (loguea): el llamador ve NULL y stats.failed */
+void* heap_tlsf_malloc_from_isr(size_t size)
+{
+	UBaseType_t mask = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_HEAP);
+	void* ptr = heap_malloc_(size);
+	CRITICAL_EXIT_FROM_ISR(mask);
+	return ptr;
+}
+
+void heap_tlsf_free_from_isr(void* ptr)
+{
+	if (NULL == ptr)
+	{
+		return;
+	}
+
+	UBaseType_t mask = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_HEAP);
+	heap_free_(ptr);
+	CRITICAL_EXIT_FROM_ISR(mask);
+}
+
+#endif
+
+#endif /* HEAP_TLSF_CONFIG_ENABLE */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : latency.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "timebase.h"
+#include "critical.h"
+
+#include "latency.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_all;
+    uint32_t sample[LATENCY_CONFIG_WINDOW];
+} latency_window_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static latency_window_t window_[LATENCY_STAGE__N];
+
+/********************** external data definition *****************************/
+
+const char* const latency_stage_name[LATENCY_STAGE__N] =
+{
+    "debounce",
+    "ui_queue",
+    "ui_process",
+    "led_queue",
+    "led_process",
+    "total",
+};
+
+/********************** internal functions definition ************************/
+
+static void latency_add_(latency_stage_t stage, uint32_t cycles)
+{
+    latency_window_t* pwindow = &window_[stage];
+    pwindow->sample[pwindow->count % LATENCY_CONFIG_WINDOW] = cycles;
+    pwindow->count++;
+    if (cycles > pwindow->max_all)
+    {
+        pwindow->max_all = cycles;
+    }
+}
+
+static bool latency_has_(const latency_stamp_t* pstamp, latency_hop_t from, latency_hop_t to)
+{
+    uint32_t mask = (1UL << from) | (1UL << to);
+    return (mask == (pstamp->hops & mask));
+}
+
+/* Percentil por rango mas cercano sobre muestras ordenadas */
+static uint32_t latency_percentile_(const uint32_t* sorted, uint32_t n, uint32_t percent)
+{
+    uint32_t rank = (n * percent + 99) / 100;
+    return sorted[(0 < rank) ? (rank - 1) : 0];
+}
+
+/********************** external functions definition ************************/
+
+void latency_init(void)
+{
+    latency_reset();
+}
+
+/* Un evento que llego al pin: cada etapa se registra si tiene sus dos sellos.
+ * Lo llaman los ao_led, que pueden desalojarse entre si */
+void latency_record(const latency_stamp_t* pstamp)
+{
+#if 1 == LATENCY_CONFIG_ENABLE
+    CRITICAL_ENTER(CRITICAL_SITE_LATENCY_RECORD);
+    for (uint32_t stage = 0; stage < LATENCY_STAGE_TOTAL; stage++)
+    {
+        if (latency_has_(pstamp, (latency_hop_t)stage, (latency_hop_t)(stage + 1)))
+        {
+            latency_add_((latency_stage_t)stage, pstamp->time[stage + 1] - pstamp->time[stage]);
+        }
+    }
+    if (latency_has_(pstamp, LATENCY_HOP_EDGE, LATENCY_HOP_GPIO))
+    {
+        latency_add_(LATENCY_STAGE_TOTAL, pstamp->time[LATENCY_HOP_GPIO] - pstamp->time[LATENCY_HOP_EDGE]);
+    }
+    CRITICAL_EXIT();
+#endif
+}
+
+/* Copia la ventana y la ordena fuera de la seccion critica (insercion, la
+ * ventana es chica) */
+bool latency_get(latency_stage_t stage, latency_stats_t* pstats)
+{
+    uint32_t sorted[LATENCY_CONFIG_WINDOW];
+
+    if (LATENCY_STAGE__N <= stage)
+    {
+        return false;
+    }
+
+    CRITICAL_ENTER(CRITICAL_SITE_LATENCY_GET);
+    pstats->count = window_[stage].count;
+    pstats->max_all = window_[stage].max_all;
+    pstats->samples = (pstats->count < LATENCY_CONFIG_WINDOW) ? pstats->count : LATENCY_CONFIG_WINDOW;
+    memcpy(sorted, window_[stage].sample, pstats->samples * sizeof(uint32_t));
+    CRITICAL_EXIT();
+
+    for (uint32_t i = 1; i < pstats->samples; i++)
+    {
+        uint32_t value = sorted[i];
+        uint32_t j = i;
+        while ((0 < j) && (sorted[j - 1] > value))
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    if (0 == pstats->samples)
+    {
+        pstats->p50 = 0;
+        pstats->p99 = 0;
+        pstats->max = 0;
+        return true;
+    }
+    pstats->p50 = latency_percentile_(sorted, pstats->samples, 50);
+    pstats->p99 = latency_percentile_(sorted, pstats->samples, 99);
+    pstats->max = sorted[pstats->samples - 1];
+    return true;
+}
+
+void latency_reset(void)
+{
+    taskENTER_CRITICAL();
+    memset(window_, 0, sizeof(window_));
+    taskEXIT_CRITICAL();
+}
+
+void latency_report(void)
+{
+    latency_stats_t stats;
+
+    for (uint32_t i = 0; i < LATENCY_STAGE__N; i++)
+    {
+        (void)latency_get((latency_stage_t)i, &stats);
+        if (0 == stats.samples)
+        {
+            continue;
+        }
+        LOGGER_INFO("lat %s: p50=%lu p99=%lu max=%lu us", latency_stage_name[i],
+                    stats.p50, stats.p99, stats.max);
+    }
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : led_pwm.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "critical.h"
+
+#include "led_pwm.h"
+
+/********************** macros and definitions *******************************/
+
+#define DIM_PRESCALER_           (LED_PWM_TIM_CLOCK_HZ / LED_PWM_DIM_COUNT_HZ - 1)
+#define BLINK_PRESCALER_         (LED_PWM_TIM_CLOCK_HZ / LED_PWM_BLINK_COUNT_HZ - 1)
+#define DIM_PERIOD_HZ_           (LED_PWM_DIM_COUNT_HZ / LED_PWM_DIM_COUNTS)
+#define REPETITION_MAX_          (256)
+
+/* Banderas de DMA2 Stream1: sin limpiarlas el stream no vuelve a arrancar */
+#define LED_PWM_DMA_FLAGS_       (DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1\
+                                  | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1)
+
+/********************** internal data declaration ****************************/
+
+typedef enum
+{
+    LED_PWM_MODE_DIM,
+    LED_PWM_MODE_BLINK,
+} led_pwm_mode_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+#if (1 == LED_PWM_CONFIG_ENABLE)
+static uint16_t level_;                 // brillo fijo o destino del fundido
+static led_pwm_mode_t mode_;
+static uint16_t fade_from_;
+static uint16_t fade_steps_;            // 0: no hay fundido en curso
+static uint16_t fade_table_[LED_PWM_CONFIG_FADE_STEPS];
+#endif
+
+/********************** external data definition *****************************/
+
+#if (1 == LED_PWM_CONFIG_ENABLE)
+extern TIM_HandleTypeDef htim8;
+extern DMA_HandleTypeDef hdma_tim8_up;
+#endif
+
+/********************** internal functions definition ************************/
+
+#if (1 == LED_PWM_CONFIG_ENABLE)
+
+/* El ojo es casi cuadratico: a mitad de escala el duty es un cuarto */
+static uint16_t gamma_(uint32_t level)
+{
+    return (uint16_t)((level * level * LED_PWM_DIM_COUNTS) / ((uint32_t)LED_PWM_LEVEL_MAX * LED_PWM_LEVEL_MAX));
+}
+
+/* Con UG se cargan ya PSC, ARR, RCR y CCR1, que tienen precarga */
+static void led_pwm_load_(uint32_t prescaler, uint32_t period, uint32_t repetition, uint32_t compare)
+{
+    LED_PWM_TIM->PSC = prescaler;
+    LED_PWM_TIM->ARR = period;
+    LED_PWM_TIM->RCR = repetition;
+    LED_PWM_TIM->CCR1 = compare;
+    LED_PWM_TIM->EGR = TIM_EGR_UG;
+}
+
+/* Corta el fundido en curso y devuelve el brillo al que llego */
+static uint16_t led_pwm_fade_stop_(void)
+{
+    LED_PWM_TIM->DIER &= ~TIM_DIER_UDE;
+    __HAL_DMA_DISABLE(&hdma_tim8_up);
+    while (0 != (hdma_tim8_up.Instance->CR & DMA_SxCR_EN))
+    {
+    }
+
+    if (0 != fade_steps_)
+    {
+        int32_t done = (int32_t)fade_steps_ - (int32_t)hdma_tim8_up.Instance->NDTR;
+        level_ = (uint16_t)(fade_from_ + ((int32_t)level_ - fade_from_) * done / fade_steps_);
+        fade_steps_ = 0;
+
+        // El fundido dejo RCR en hold - 1: sin recargarlo, el proximo CCR1 de
+        // led_pwm_dim_ tardaria hasta 256 periodos en aplicarse
+        led_pwm_load_(DIM_PRESCALER_, LED_PWM_DIM_COUNTS - 1, 0, gamma_(level_));
+    }
+    return level_;
+}
+
+static void led_pwm_dim_(uint16_t compare)
+{
+    if (LED_PWM_MODE_DIM == mode_)
+    {
+        LED_PWM_TIM->CCR1 = compare;
+    }
+    else
+    {
+        led_pwm_load_(DIM_PRESCALER_, LED_PWM_DIM_COUNTS - 1, 0, compare);
+        mode_ = LED_PWM_MODE_DIM;
+    }
+}
+
+#endif
+
+/********************** external functions definition ************************/
+
+#if (1 == LED_PWM_CONFIG_ENABLE)
+
+/* TIM8 ya esta configurado por MX_TIM8_Init: PWM1 en CH1N a 1 kHz y el DMA
+ * de TIM8_UP (DMA2 Stream1) de memoria a CCR1 en medias palabras */
+void led_pwm_init(void)
+{
+    level_ = 0;
+    mode_ = LED_PWM_MODE_DIM;
+    fade_steps_ = 0;
+    led_pwm_load_(DIM_PRESCALER_, LED_PWM_DIM_COUNTS - 1, 0, 0);
+    HAL_TIMEx_PWMN_Start(&htim8, TIM_CHANNEL_1);
+}
+
+void led_pwm_set(uint16_t level)
+{
+    level = (LED_PWM_LEVEL_MAX < level) ? LED_PWM_LEVEL_MAX : level;
+
+    CRITICAL_ENTER(CRITICAL_SITE_LED_PWM_SET);
+    {
+        (void)led_pwm_fade_stop_();
+        level_ = level;
+        led_pwm_dim_(gamma_(level));
+    }
+    CRITICAL_EXIT();
+}
+
+/* duty en por mil del periodo. Un parpadeo no consume CPU ni interrupciones:
+ * es el PWM con el periodo del parpadeo */
+bool led_pwm_blink(uint16_t period_ms, uint16_t duty)
+{
+    if ((0 == period_ms) || (LED_PWM_BLINK_PERIOD_MAX_MS < period_ms) || (LED_PWM_LEVEL_MAX < duty))
+    {
+        return false;
+    }
+
+    uint32_t counts = (uint32_t)period_ms * (LED_PWM_BLINK_COUNT_HZ / 1000);
+
+    CRITICAL_ENTER(CRITICAL_SITE_LED_PWM_BLINK);
+    {
+        (void)led_pwm_fade_stop_();
+        led_pwm_load_(BLINK_PRESCALER_, counts - 1, 0, counts * duty / LED_PWM_LEVEL_MAX);
+        mode_ = LED_PWM_MODE_BLINK;
+        level_ = 0;     // un fundido posterior arranca desde apagado
+    }
+    CRITICAL_EXIT();
+    return true;
+}
+
+/* Rampa desde el brillo actual hasta level en ms. La CPU arma la tabla una vez;
+ * despues el evento de actualizacion de TIM8 pide al DMA el proximo CCR1 cada
+ * RCR + 1 periodos, y al terminar el ultimo valor queda fijo */
+bool led_pwm_fade(uint16_t level, uint32_t ms)
+{
+    if (LED_PWM_FADE_MAX_MS < ms)
+    {
+        return false;
+    }
+
+    level = (LED_PWM_LEVEL_MAX < level) ? LED_PWM_LEVEL_MAX : level;
+    uint32_t periods = ms * DIM_PERIOD_HZ_ / 1000;
+    if (0 == periods)
+    {
+        led_pwm_set(level);
+        return true;
+    }
+
+    uint32_t steps = (LED_PWM_CONFIG_FADE_STEPS < periods) ? LED_PWM_CONFIG_FADE_STEPS : periods;
+    uint32_t hold = periods / steps;
+    hold = (REPETITION_MAX_ < hold) ? REPETITION_MAX_ : hold;
+
+    CRITICAL_ENTER(CRITICAL_SITE_LED_PWM_FADE);
+    {
+        // Desde un parpadeo level_ es 0
+        int32_t from = led_pwm_fade_stop_();
+
+        for (uint32_t i = 0; i < steps; i++)
+        {
+            fade_table_[i] = gamma_((uint32_t)(from + ((int32_t)level - from) * (int32_t)(i + 1) / (int32_t)steps));
+        }
+        fade_from_ = (uint16_t)from;
+        fade_steps_ = (uint16_t)steps;
+        level_ = level;
+
+        led_pwm_load_(DIM_PRESCALER_, LED_PWM_DIM_COUNTS - 1, hold - 1, gamma_((uint32_t)from));
+        mode_ = LED_PWM_MODE_DIM;
+
+        DMA_Stream_TypeDef* stream = hdma_tim8_up.Instance;
+        DMA2->LIFCR = LED_PWM_DMA_FLAGS_;
+        stream->PAR = (uint32_t)(uintptr_t)&LED_PWM_TIM->CCR1;
+        stream->M0AR = (uint32_t)(uintptr_t)fade_table_;
+        stream->NDTR = steps;
+        __HAL_DMA_ENABLE(&hdma_tim8_up);
+        LED_PWM_TIM->DIER |= TIM_DIER_UDE;
+    }
+    CRITICAL_EXIT();
+    return true;
+}
+
+uint16_t led_pwm_level(void)
+{
+    return level_;
+}
+
+#endif
+
+/********************** end of file ******************************************/
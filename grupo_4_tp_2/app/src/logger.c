@@ -41,41 +41,578 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdarg.h>
 
 #include "main.h"
 #include "cmsis_os.h"
 
 #include "logger.h"
+#include "dwt.h"
+#include "timebase.h"
+#include "profiler.h"
+#include "critical.h"
 
 /********************** macros and definitions *******************************/
 
+#define DEFERRED_MASK_           (LOGGER_CONFIG_DEFERRED_CAPACITY - 1)
+
+#if 0 != (LOGGER_CONFIG_DEFERRED_CAPACITY & DEFERRED_MASK_)
+#error "LOGGER_CONFIG_DEFERRED_CAPACITY debe ser potencia de 2"
+#endif
+
 /********************** internal data declaration ****************************/
 
+/* Registro diferido: seq implementa la cola MPMC acotada de D. Vyukov, cada
+ * slot sabe si esta libre (seq == pos) o listo para leer (seq == pos + 1). */
+typedef struct
+{
+    volatile uint32_t seq;
+    const char* prefix;
+    const char* fmt;
+    uint32_t nargs;
+    uint32_t timestamp;
+    uintptr_t args[LOGGER_CONFIG_DEFERRED_MAX_ARGS];
+} logger_record_t_;
+
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
 
+#if 1 == LOGGER_CONFIG_USE_DEFERRED
+static logger_record_t_ deferred_queue_[LOGGER_CONFIG_DEFERRED_CAPACITY];
+static volatile uint32_t deferred_head_;
+static volatile uint32_t deferred_tail_;
+static volatile uint32_t deferred_done_;    // posiciones ya entregadas al transporte
+static TaskHandle_t logger_task_h_ = NULL;
+#endif
+
+#if 1 == LOGGER_CONFIG_USE_BINARY
+static uint32_t binary_dropped_reported_;
+#if 1 == LOGGER_CONFIG_USE_SEMIHOSTING
+static FILE* binary_file_ = NULL;
+#endif
+#endif
+
+static logger_stats_t logger_stats_;
+
+#if 1 == LOGGER_CONFIG_USE_UART_DMA
+extern UART_HandleTypeDef huart2;
+
+/* Doble buffer: los escritores llenan buffer[fill_idx] mientras el DMA envia
+ * el otro; al completar se lanza el siguiente sin esperar a nadie */
+static struct
+{
+    uint8_t buffer[2][LOGGER_CONFIG_UART_BUFFER_SIZE];
+    volatile uint32_t fill_len;
+    volatile uint32_t fill_idx;
+    volatile bool busy;
+    volatile bool polling;
+} logger_uart_;
+#endif
+
 /********************** external data definition *****************************/
 
 static char logger_msg_buffer_[LOGGER_CONFIG_MAXLEN];
 char* const logger_msg = logger_msg_buffer_;
 int logger_msg_len;
+volatile uint32_t logger_runtime_mask = 0xFFFFFFFF;
 
 /********************** internal functions definition ************************/
 
+static void logger_cycles_update_(uint32_t cycles)
+{
+    profiler_record(PROFILER_PROBE_LOGGER, cycles);
+    logger_stats_.cycles_last = cycles;
+    if (cycles > logger_stats_.cycles_max)
+    {
+        logger_stats_.cycles_max = cycles;
+    }
+}
+
+/* Arma el registro completo en logger_msg: [timestamp] prefijo cuerpo '\n'.
+ * Si el cuerpo no entra se marca el final con LOGGER_CONFIG_TRUNCATION_MARK */
+static int logger_format_v_(uint32_t timestamp, const char* prefix, const char* fmt, va_list ap)
+{
+    const int body_max = LOGGER_CONFIG_MAXLEN - 2;  // lugar para '\n' y '\0'
+    int len = 0;
+    int n;
+
+#if 1 == LOGGER_CONFIG_USE_TIMESTAMP
+    n = snprintf(logger_msg, body_max + 1, "[%lu] ", (unsigned long)timestamp);
+    len = (n < body_max) ? n : body_max;
+#endif
+
+    n = snprintf(logger_msg + len, (body_max + 1) - len, "%s", prefix);
+    len = ((len + n) < body_max) ? (len + n) : body_max;
+
+    n = vsnprintf(logger_msg + len, (body_max + 1) - len, fmt, ap);
+    if ((len + n) > body_max)
+    {
+        len = body_max;
+        memcpy(&logger_msg[len - (sizeof(LOGGER_CONFIG_TRUNCATION_MARK) - 1)],
+               LOGGER_CONFIG_TRUNCATION_MARK, sizeof(LOGGER_CONFIG_TRUNCATION_MARK) - 1);
+        logger_stats_.truncated++;
+    }
+    else
+    {
+        len += n;
+    }
+
+    logger_msg[len++] = '\n';
+    logger_msg[len] = '\0';
+    logger_msg_len = len;
+    return len;
+}
+
+#if (1 == LOGGER_CONFIG_USE_DEFERRED) && (1 != LOGGER_CONFIG_USE_BINARY)
+static int logger_format_(uint32_t timestamp, const char* prefix, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int len = logger_format_v_(timestamp, prefix, fmt, ap);
+    va_end(ap);
+    return len;
+}
+#endif
+
+#if 1 == LOGGER_CONFIG_USE_UART_DMA
+// Llamar con interrupciones enmascaradas
+static void logger_uart_kick_(void)
+{
+    if (logger_uart_.busy || (0 == logger_uart_.fill_len))
+    {
+        return;
+    }
+
+    uint32_t idx = logger_uart_.fill_idx;
+    uint32_t len = logger_uart_.fill_len;
+    logger_uart_.fill_idx = idx ^ 1;
+    logger_uart_.fill_len = 0;
+    logger_stats_.transport_used = 0;
+
+    if (HAL_OK == HAL_UART_Transmit_DMA(&huart2, logger_uart_.buffer[idx], len))
+    {
+        logger_uart_.busy = true;
+        logger_stats_.transport_bytes += len;
+        logger_stats_.transport_chunks++;
+    }
+    else
+    {
+        logger_stats_.transport_overruns++;
+    }
+}
+
+/* Desde un handler de falla las IRQ de DMA/UART ya no corren: se espera la
+ * transferencia en curso, se envia lo pendiente y se pasa a modo polling */
+static void logger_uart_sync_(void)
+{
+    while (logger_uart_.busy && (0 != __HAL_DMA_GET_COUNTER(huart2.hdmatx)))
+    {
+    }
+    HAL_UART_AbortTransmit(&huart2);
+    logger_uart_.busy = false;
+    logger_uart_.polling = true;
+
+    if (0 < logger_uart_.fill_len)
+    {
+        HAL_UART_Transmit(&huart2, logger_uart_.buffer[logger_uart_.fill_idx], logger_uart_.fill_len, HAL_MAX_DELAY);
+        logger_stats_.transport_bytes += logger_uart_.fill_len;
+        logger_uart_.fill_len = 0;
+    }
+}
+#endif
+
+#if 1 == LOGGER_CONFIG_USE_DEFERRED
+static void logger_notify_(void)
+{
+    if (NULL == logger_task_h_)
+    {
+        return;
+    }
+
+    if (xPortIsInsideInterrupt())
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(logger_task_h_, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+    else if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState())
+    {
+        xTaskNotifyGive(logger_task_h_);
+    }
+}
+
+/* Unico consumidor: la tarea del logger, o logger_flush() cuando la tarea
+ * ya no puede correr (ISR, handler de falla, scheduler detenido) */
+static bool logger_deferred_pop_(logger_record_t_* prec)
+{
+    uint32_t pos = deferred_tail_;
+    logger_record_t_* pslot = &deferred_queue_[pos & DEFERRED_MASK_];
+
+    if ((pos + 1) != __atomic_load_n(&pslot->seq, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    *prec = *pslot;
+    __atomic_store_n(&pslot->seq, pos + LOGGER_CONFIG_DEFERRED_CAPACITY, __ATOMIC_RELEASE);
+    deferred_tail_ = pos + 1;
+    return true;
+}
+
+#if 1 != LOGGER_CONFIG_USE_BINARY
+static void logger_deferred_print_(const logger_record_t_* prec)
+{
+    const uintptr_t* a = prec->args;
+    logger_format_(prec->timestamp, prec->prefix, prec->fmt, a[0], a[1], a[2], a[3]);
+    logger_log_print_(logger_msg);
+    logger_stats_.printed++;
+}
+#endif
+
+#if 1 == LOGGER_CONFIG_USE_BINARY
+static uint32_t logger_binary_put_u32_(uint8_t* pbuf, uint32_t value)
+{
+    pbuf[0] = (uint8_t)(value);
+    pbuf[1] = (uint8_t)(value >> 8);
+    pbuf[2] = (uint8_t)(value >> 16);
+    pbuf[3] = (uint8_t)(value >> 24);
+    return 4;
+}
+
+/* Trama: [SYNC|nargs] [id lo] [id hi] [timestamp u32] [arg u32]*nargs (LE) */
+static void logger_binary_emit_(uint16_t id, uint32_t timestamp, uint32_t nargs, const uintptr_t* args)
+{
+    uint8_t frame[3 + 4 + (4 * LOGGER_CONFIG_DEFERRED_MAX_ARGS)];
+    uint32_t len = 0;
+
+    frame[len++] = (uint8_t)(LOGGER_BINARY_SYNC | nargs);
+    frame[len++] = (uint8_t)(id);
+    frame[len++] = (uint8_t)(id >> 8);
+    len += logger_binary_put_u32_(&frame[len], timestamp);
+    for (uint32_t i = 0; i < nargs; i++)
+    {
+        len += logger_binary_put_u32_(&frame[len], (uint32_t)args[i]);
+    }
+    logger_log_write_(frame, len);
+}
+
+static void logger_binary_print_(const logger_record_t_* prec)
+{
+    uint32_t dropped = logger_stats_.dropped;
+    if (dropped != binary_dropped_reported_)
+    {
+        uintptr_t lost = dropped - binary_dropped_reported_;
+        binary_dropped_reported_ = dropped;
+        logger_binary_emit_(LOGGER_BINARY_ID_DROPPED, prec->timestamp, 1, &lost);
+    }
+
+    // .logger_fmt se enlaza en la direccion 0: la direccion es el ID
+    logger_binary_emit_((uint16_t)(uintptr_t)prec->fmt, prec->timestamp, prec->nargs, prec->args);
+    logger_stats_.printed++;
+}
+#endif
+
+static void logger_deferred_drain_(void)
+{
+    logger_record_t_ rec;
+    while (logger_deferred_pop_(&rec))
+    {
+#if 1 == LOGGER_CONFIG_USE_BINARY
+        logger_binary_print_(&rec);
+#else
+        logger_deferred_print_(&rec);
+#endif
+        deferred_done_ = deferred_tail_;
+    }
+}
+
+/* Desde una tarea no se consume: se despierta a la tarea del logger y se
+ * espera a que entregue todo lo encolado hasta ahora (y a que el transporte
+ * termine). Devuelve false si el contexto no permite esperar */
+static bool logger_flush_from_task_(void)
+{
+    if ((NULL == logger_task_h_) || xPortIsInsideInterrupt() ||
+        (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) ||
+        (logger_task_h_ == xTaskGetCurrentTaskHandle()))
+    {
+        return false;
+    }
+
+    uint32_t target = deferred_head_;
+    while (0 < (int32_t)(target - deferred_done_))
+    {
+        xTaskNotifyGive(logger_task_h_);
+        vTaskDelay(1);
+    }
+#if 1 == LOGGER_CONFIG_USE_UART_DMA
+    while (logger_uart_.busy || (0 != logger_uart_.fill_len))
+    {
+        vTaskDelay(1);
+    }
+#endif
+    return true;
+}
+
+static void task_logger_(void* argument)
+{
+    while (true)
+    {
+        logger_deferred_drain_();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOGGER_CONFIG_TASK_PERIOD_MS));
+    }
+}
+#endif
+
 /********************** external functions definition ************************/
 
+void logger_init(void)
+{
+#if 1 == LOGGER_CONFIG_USE_DEFERRED
+    for (uint32_t i = 0; i < LOGGER_CONFIG_DEFERRED_CAPACITY; i++)
+    {
+        deferred_queue_[i].seq = i;
+    }
+    deferred_head_ = 0;
+    deferred_tail_ = 0;
+    deferred_done_ = 0;
+    memset(&logger_stats_, 0, sizeof(logger_stats_));
+#if 1 == LOGGER_CONFIG_USE_BINARY
+    binary_dropped_reported_ = 0;
+#if 1 == LOGGER_CONFIG_USE_SEMIHOSTING
+    binary_file_ = fopen(LOGGER_CONFIG_BINARY_FILE, "wb");
+#endif
+#endif
+
+    BaseType_t status;
+    status = xTaskCreate(task_logger_, "task_logger", LOGGER_CONFIG_TASK_STACK_SIZE, NULL, LOGGER_CONFIG_TASK_PRIORITY, &logger_task_h_);
+    while (pdPASS != status)
+    {
+        // error
+    }
+#endif
+}
+
+/* Modo inmediato: una sola seccion critica y una sola llamada al transporte
+ * por linea, asi las lineas de distintas tareas no se intercalan */
+void logger_log_record_(const char* prefix, const char* fmt, ...)
+{
+    uint32_t start = cycle_counter_get();
+    uint32_t timestamp = timebase_us32();
+
+    CRITICAL_ENTER(CRITICAL_SITE_LOGGER_RECORD);
+    {
+        va_list ap;
+        va_start(ap, fmt);
+        logger_format_v_(timestamp, prefix, fmt, ap);
+        va_end(ap);
+        logger_log_print_(logger_msg);
+        logger_stats_.pushed++;
+        logger_stats_.printed++;
+        logger_cycles_update_(cycle_counter_get() - start);
+    }
+    CRITICAL_EXIT();
+}
+
+#if 1 == LOGGER_CONFIG_USE_DEFERRED
+bool logger_deferred_push_(const char* prefix, uint32_t nargs, const char* fmt, ...)
+{
+    uint32_t start = cycle_counter_get();
+    uint32_t timestamp = timebase_us32();
+    uint32_t pos = deferred_head_;
+    logger_record_t_* pslot;
+
+    for (;;)
+    {
+        pslot = &deferred_queue_[pos & DEFERRED_MASK_];
+        int32_t diff = (int32_t)(__atomic_load_n(&pslot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (0 == diff)
+        {
+            if (__atomic_compare_exchange_n(&deferred_head_, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Cola llena: se descarta el registro, nunca se bloquea al llamador
+            __atomic_fetch_add(&logger_stats_.dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        else
+        {
+            pos = deferred_head_;
+        }
+    }
+
+    if (nargs > LOGGER_CONFIG_DEFERRED_MAX_ARGS)
+    {
+        nargs = LOGGER_CONFIG_DEFERRED_MAX_ARGS;
+    }
+
+    // LOGGER_ARGS_ convirtio cada argumento a uintptr_t en la llamada
+    va_list ap;
+    va_start(ap, fmt);
+    for (uint32_t i = 0; i < LOGGER_CONFIG_DEFERRED_MAX_ARGS; i++)
+    {
+        pslot->args[i] = (i < nargs) ? va_arg(ap, uintptr_t) : 0;
+    }
+    va_end(ap);
+
+    pslot->prefix = prefix;
+    pslot->fmt = fmt;
+    pslot->nargs = nargs;
+    pslot->timestamp = timestamp;
+    __atomic_store_n(&pslot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&logger_stats_.pushed, 1, __ATOMIC_RELAXED);
+    uint32_t used = (pos + 1) - deferred_tail_;
+    if (used > logger_stats_.max_used)
+    {
+        logger_stats_.max_used = used;
+    }
+
+    // Solo se despierta a la tarea cuando la cola estaba vacia
+    if (pos == deferred_tail_)
+    {
+        logger_notify_();
+    }
+
+    logger_cycles_update_(cycle_counter_get() - start);
+    return true;
+}
+#endif
+
+/* Desde una tarea espera a que la tarea del logger vacie la cola. Desde una
+ * ISR, un handler de falla o con el scheduler detenido (la tarea del logger
+ * no corre) la vacia en el contexto actual y pasa el transporte a polling */
+void logger_flush(void)
+{
+#if 1 == LOGGER_CONFIG_USE_DEFERRED
+    if (logger_flush_from_task_())
+    {
+        return;
+    }
+#endif
+#if 1 == LOGGER_CONFIG_USE_UART_DMA
+    logger_uart_sync_();
+#endif
+#if 1 == LOGGER_CONFIG_USE_DEFERRED
+    logger_deferred_drain_();
+#endif
+}
+
+void logger_get_stats(logger_stats_t* pstats)
+{
+    *pstats = logger_stats_;
+}
+
+/* Habilita en runtime los niveles <= level del modulo; el umbral de
+ * compilacion sigue mandando */
+void logger_set_level(uint32_t module, uint32_t level)
+{
+    uint32_t bits = 0;
+    for (uint32_t l = LOGGER_LEVEL_ERROR; l <= LOGGER_LEVEL_TRACE; l++)
+    {
+        bits |= LOGGER_RUNTIME_BIT_(module, l);
+    }
+
+    uint32_t enabled = 0;
+    for (uint32_t l = LOGGER_LEVEL_ERROR; l <= level; l++)
+    {
+        enabled |= LOGGER_RUNTIME_BIT_(module, l);
+    }
+
+    taskENTER_CRITICAL();
+    logger_runtime_mask = (logger_runtime_mask & ~bits) | enabled;
+    taskEXIT_CRITICAL();
+}
+
+#if 1 != LOGGER_CONFIG_USE_UART_DMA
+void logger_uart_tx_complete_isr(void* huart)
+{
+    return;
+}
+#endif
+
 #if 1 == LOGGER_CONFIG_USE_SEMIHOSTING
 void logger_log_print_(char* const msg)
 {
 	printf(msg);
 	fflush(stdout);
 }
+
+void logger_log_write_(const uint8_t* data, size_t size)
+{
+#if 1 == LOGGER_CONFIG_USE_BINARY
+    if (NULL != binary_file_)
+    {
+        fwrite(data, 1, size, binary_file_);
+        fflush(binary_file_);
+    }
+#endif
+}
+#elif 1 == LOGGER_CONFIG_USE_UART_DMA
+void logger_log_print_(char* const msg)
+{
+    logger_log_write_((const uint8_t*)msg, strlen(msg));
+}
+
+void logger_log_write_(const uint8_t* data, size_t size)
+{
+    if (logger_uart_.polling)
+    {
+        HAL_UART_Transmit(&huart2, (uint8_t*)data, size, HAL_MAX_DELAY);
+        logger_stats_.transport_bytes += size;
+        return;
+    }
+
+    UBaseType_t mask = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_LOGGER_UART);
+    {
+        if ((LOGGER_CONFIG_UART_BUFFER_SIZE - logger_uart_.fill_len) < size)
+        {
+            // Nunca se bloquea al llamador: se descarta el registro completo
+            logger_stats_.transport_overruns++;
+        }
+        else
+        {
+            memcpy(&logger_uart_.buffer[logger_uart_.fill_idx][logger_uart_.fill_len], data, size);
+            logger_uart_.fill_len += size;
+            logger_stats_.transport_used = logger_uart_.fill_len;
+            if (logger_uart_.fill_len > logger_stats_.transport_max_used)
+            {
+                logger_stats_.transport_max_used = logger_uart_.fill_len;
+            }
+            logger_uart_kick_();
+        }
+    }
+    CRITICAL_EXIT_FROM_ISR(mask);
+}
+
+void logger_uart_tx_complete_isr(void* huart)
+{
+    if (&huart2 != huart)
+    {
+        return;
+    }
+
+    UBaseType_t mask = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_LOGGER_UART_ISR);
+    {
+        logger_uart_.busy = false;
+        logger_uart_kick_();
+    }
+    CRITICAL_EXIT_FROM_ISR(mask);
+}
 #else
 void logger_log_print_(char* const msg)
 {
     return;
 }
+
+void logger_log_write_(const uint8_t* data, size_t size)
+{
+    return;
+}
 #endif
 
 /********************** end of file ******************************************/
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : mem_stats.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+
+#include "mem_stats.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static TaskStatus_t status_[MEM_STATS_CONFIG_MAX_TASKS];
+static mem_stats_task_t history_[MEM_STATS_CONFIG_MAX_TASKS];
+static uint32_t history_count_;
+
+static volatile uint32_t malloc_failed_;
+static char overflow_name_[configMAX_TASK_NAME_LEN];
+
+static mem_stats_snapshot_t snapshot_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Entrada de la tarea por nombre: los objetos activos se destruyen y se
+ * vuelven a crear, el numero de tarea cambia pero el nombre no */
+static mem_stats_task_t* mem_stats_history_(const char* name)
+{
+    for (uint32_t i = 0; i < history_count_; i++)
+    {
+        if (0 == strncmp(history_[i].name, name, configMAX_TASK_NAME_LEN))
+        {
+            return &history_[i];
+        }
+    }
+
+    if (MEM_STATS_CONFIG_MAX_TASKS <= history_count_)
+    {
+        return NULL;
+    }
+
+    mem_stats_task_t* ptask = &history_[history_count_++];
+    strncpy(ptask->name, name, configMAX_TASK_NAME_LEN - 1);
+    ptask->name[configMAX_TASK_NAME_LEN - 1] = '\0';
+    ptask->stack_free_min = UINT32_MAX;
+    return ptask;
+}
+
+/********************** external functions definition ************************/
+
+void mem_stats_init(void)
+{
+    history_count_ = 0;
+
+#if 1 == MEM_STATS_CONFIG_ENABLE
+    BaseType_t status;
+    status = xTaskCreate(task_mem_stats, "task_mem_stats", MEM_STATS_CONFIG_TASK_STACK_SIZE, NULL, MEM_STATS_CONFIG_TASK_PRIORITY, NULL);
+    while (pdPASS != status)
+    {
+        // error
+    }
+#endif
+}
+
+/* High-water mark de cada tarea y estado del heap. uxTaskGetSystemState
+ * recorre el stack de cada tarea con el scheduler suspendido: no llamar a
+ * alta frecuencia. Con mas tareas que MEM_STATS_CONFIG_MAX_TASKS no devuelve
+ * ninguna: el heap se informa igual y los stacks quedan del muestreo previo */
+bool mem_stats_snapshot(mem_stats_snapshot_t* psnapshot)
+{
+    UBaseType_t count = uxTaskGetSystemState(status_, MEM_STATS_CONFIG_MAX_TASKS, NULL);
+    bool ok = (0 != count);
+
+    if (ok)
+    {
+        for (uint32_t i = 0; i < history_count_; i++)
+        {
+            history_[i].alive = false;
+        }
+    }
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        mem_stats_task_t* ptask = mem_stats_history_(status_[i].pcTaskName);
+        if (NULL == ptask)
+        {
+            ok = false;
+            continue;
+        }
+        ptask->alive = true;
+        if (status_[i].usStackHighWaterMark < ptask->stack_free_min)
+        {
+            ptask->stack_free_min = status_[i].usStackHighWaterMark;
+        }
+    }
+
+    HeapStats_t heap;
+    vPortGetHeapStats(&heap);
+    psnapshot->heap_free = heap.xAvailableHeapSpaceInBytes;
+    psnapshot->heap_free_min = heap.xMinimumEverFreeBytesRemaining;
+    psnapshot->heap_largest_free = heap.xSizeOfLargestFreeBlockInBytes;
+    psnapshot->heap_free_blocks = heap.xNumberOfFreeBlocks;
+    psnapshot->heap_allocs = heap.xNumberOfSuccessfulAllocations;
+    psnapshot->heap_frees = heap.xNumberOfSuccessfulFrees;
+    psnapshot->malloc_failed = malloc_failed_;
+    psnapshot->count = history_count_;
+    psnapshot->alive = (0 != count) ? count : uxTaskGetNumberOfTasks();
+    psnapshot->truncated = !ok;
+    memcpy(psnapshot->task, history_, history_count_ * sizeof(history_[0]));
+
+    return ok;
+}
+
+void mem_stats_report(const mem_stats_snapshot_t* psnapshot)
+{
+    if (psnapshot->truncated)
+    {
+        LOGGER_WARN("mem: %lu tareas, maximo %lu: stacks incompletos", psnapshot->alive,
+                    (uint32_t)MEM_STATS_CONFIG_MAX_TASKS);
+    }
+    LOGGER_INFO("mem: heap libre=%lu min=%lu bloque max=%lu fallos=%lu", psnapshot->heap_free,
+                psnapshot->heap_free_min, psnapshot->heap_largest_free, psnapshot->malloc_failed);
+    LOGGER_INFO("mem: heap bloques libres=%lu allocs=%lu frees=%lu", psnapshot->heap_free_blocks,
+                psnapshot->heap_allocs, psnapshot->heap_frees);
+    for (uint32_t i = 0; i < psnapshot->count; i++)
+    {
+        const mem_stats_task_t* ptask = &psnapshot->task[i];
+        if (ptask->stack_free_min < MEM_STATS_CONFIG_STACK_WARN_WORDS)
+        {
+            LOGGER_WARN("mem %s: stack libre min %lu palabras%s", ptask->name, ptask->stack_free_min,
+                        ptask->alive ? "" : " (eliminada)");
+        }
+        else
+        {
+            LOGGER_INFO("mem %s: stack libre min %lu palabras%s", ptask->name, ptask->stack_free_min,
+                        ptask->alive ? "" : " (eliminada)");
+        }
+    }
+}
+
+void task_mem_stats(void* argument)
+{
+    while (true)
+    {
+        // Con mas tareas que el maximo tambien se informa (el reporte avisa)
+        (void)mem_stats_snapshot(&snapshot_);
+        mem_stats_report(&snapshot_);
+        vTaskDelay(pdMS_TO_TICKS(MEM_STATS_CONFIG_REPORT_PERIOD_MS));
+    }
+}
+
+/* configCHECK_FOR_STACK_OVERFLOW = 2: se llama desde el cambio de contexto
+ * con la tarea ya corrompida, no se puede seguir. El logger diferido es
+ * seguro en este contexto y logger_flush lo vacia sin el scheduler */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskName)
+{
+    (void)xTask;
+
+    // El TCB puede estar corrupto: copia acotada del nombre
+    strncpy(overflow_name_, pcTaskName, configMAX_TASK_NAME_LEN - 1);
+    overflow_name_[configMAX_TASK_NAME_LEN - 1] = '\0';
+    LOGGER_ERROR("stack overflow en %s", overflow_name_);
+    logger_flush();
+
+    taskDISABLE_INTERRUPTS();
+    while (true)
+    {
+        // error
+    }
+}
+
+/* pvPortMalloc devolvio NULL: se informa y el llamador maneja el error */
+void vApplicationMallocFailedHook(void)
+{
+    malloc_failed_++;
+    LOGGER_ERROR("malloc fallo (%lu): heap libre=%lu min=%lu", malloc_failed_,
+                 (uint32_t)xPortGetFreeHeapSize(), (uint32_t)xPortGetMinimumEverFreeHeapSize());
+}
+
+/********************** end of file ******************************************/
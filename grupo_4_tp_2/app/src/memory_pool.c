@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : memory_pool.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "critical.h"
+
+#include "memory_pool.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/********************** external functions definition ************************/
+
+void memory_pool_init(memory_pool_t* pool, const char* name, void* storage, size_t block_size, size_t block_count)
+{
+    pool->name = name;
+    pool->begin = (uint8_t*)storage;
+    pool->end = pool->begin + (block_size * block_count);
+    pool->block_size = block_size;
+    pool->block_count = block_count;
+    pool->used = 0;
+    pool->high_water = 0;
+    pool->exhausted = 0;
+
+    // Lista libre enlazada dentro de los mismos bloques
+    pool->free_list = NULL;
+    for (size_t i = block_count; 0 < i; i--)
+    {
+        void** pblock = (void**)(pool->begin + ((i - 1) * block_size));
+        *pblock = pool->free_list;
+        pool->free_list = pblock;
+    }
+}
+
+/* O(1): saca la cabeza de la lista libre. Se puede llamar desde ISR, la
+ * seccion critica solo enmascara hasta configMAX_SYSCALL_INTERRUPT_PRIORITY */
+void* memory_pool_block_get(memory_pool_t* pool)
+{
+    void** pblock;
+
+    UBaseType_t mask = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_MEMORY_POOL_GET);
+    {
+        pblock = (void**)pool->free_list;
+        if (NULL != pblock)
+        {
+            pool->free_list = *pblock;
+            pool->used++;
+            if (pool->used > pool->high_water)
+            {
+                pool->high_water = pool->used;
+            }
+        }
+        else
+        {
+            pool->exhausted++;
+        }
+    }
+    CRITICAL_EXIT_FROM_ISR(mask);
+
+    return pblock;
+}
+
+/* Un puntero ajeno o un doble free son errores del llamador: se atrapan con
+ * configASSERT, como vPortFree. Sin asserts se rechazan sin tocar el pool.
+ * El doble free se detecta por used (no pueden volver mas bloques de los que
+ * salieron) y por la cabeza de la lista; uno mas viejo exigiria recorrerla */
+bool memory_pool_block_put(memory_pool_t* pool, void* block)
+{
+    bool owns = memory_pool_owns(pool, block);
+    configASSERT(owns);
+    if (!owns)
+    {
+        return false;
+    }
+
+    bool ok;
+    UBaseType_t mask = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_MEMORY_POOL_PUT);
+    {
+        ok = (0 < pool->used) && (block != pool->free_list);
+        if (ok)
+        {
+            *(void**)block = pool->free_list;
+            pool->free_list = block;
+            pool->used--;
+        }
+    }
+    CRITICAL_EXIT_FROM_ISR(mask);
+
+    configASSERT(ok);
+    return ok;
+}
+
+bool memory_pool_owns(const memory_pool_t* pool, const void* block)
+{
+    const uint8_t* p = (const uint8_t*)block;
+    return (pool->begin <= p) && (p < pool->end) && (0 == ((size_t)(p - pool->begin) % pool->block_size));
+}
+
+/********************** end of file ******************************************/
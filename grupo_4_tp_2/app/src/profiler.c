@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : profiler.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+
+#include "profiler.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static profiler_stats_t probes_[PROFILER_PROBE__N];
+
+/********************** external data definition *****************************/
+
+const char* const profiler_probe_name[PROFILER_PROBE__N] =
+{
+    "button_isr",
+    "button_engine",
+    "ao_ui",
+    "ao_led",
+    "logger",
+    "tickless_wake",
+};
+
+/********************** internal functions definition ************************/
+
+static inline uint32_t profiler_bin_(uint32_t cycles)
+{
+    uint32_t bin = 32 - __CLZ(cycles);
+    return (bin < PROFILER_CONFIG_HISTOGRAM_BINS) ? bin : (PROFILER_CONFIG_HISTOGRAM_BINS - 1);
+}
+
+/* Bin que alcanza el percentil pedido; la cota superior es 2^bin ciclos */
+static uint32_t profiler_percentile_bin_(const profiler_stats_t* pstats, uint32_t percent)
+{
+    uint64_t target = ((uint64_t)pstats->count * percent + 99) / 100;
+    uint64_t acc = 0;
+    for (uint32_t bin = 0; bin < PROFILER_CONFIG_HISTOGRAM_BINS; bin++)
+    {
+        acc += pstats->histogram[bin];
+        if (acc >= target)
+        {
+            return bin;
+        }
+    }
+    return PROFILER_CONFIG_HISTOGRAM_BINS - 1;
+}
+
+/********************** external functions definition ************************/
+
+void profiler_init(void)
+{
+    profiler_reset();
+}
+
+/* Desde tareas o ISR: la actualizacion es corta y va con las IRQ enmascaradas */
+void profiler_record(profiler_probe_t probe, uint32_t cycles)
+{
+    if (PROFILER_PROBE__N <= probe)
+    {
+        return;
+    }
+
+    profiler_stats_t* pstats = &probes_[probe];
+    uint32_t bin = profiler_bin_(cycles);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    {
+        pstats->count++;
+        pstats->sum += cycles;
+        if (cycles < pstats->min)
+        {
+            pstats->min = cycles;
+        }
+        if (cycles > pstats->max)
+        {
+            pstats->max = cycles;
+        }
+        pstats->histogram[bin]++;
+    }
+    __set_PRIMASK(primask);
+}
+
+/* Copia consistente de un punto, aunque se este registrando desde una ISR */
+bool profiler_get(profiler_probe_t probe, profiler_stats_t* pstats)
+{
+    if (PROFILER_PROBE__N <= probe)
+    {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *pstats = probes_[probe];
+    __set_PRIMASK(primask);
+    return true;
+}
+
+void profiler_reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(probes_, 0, sizeof(probes_));
+    for (uint32_t i = 0; i < PROFILER_PROBE__N; i++)
+    {
+        probes_[i].min = UINT32_MAX;
+    }
+    __set_PRIMASK(primask);
+}
+
+/* Dos lineas por punto (el modo diferido admite 4 argumentos): ciclos
+ * min/promedio/max y percentiles 50/99 como cota 2^k del histograma */
+void profiler_report(void)
+{
+    profiler_stats_t stats;
+
+    for (uint32_t i = 0; i < PROFILER_PROBE__N; i++)
+    {
+        (void)profiler_get((profiler_probe_t)i, &stats);
+        if (0 == stats.count)
+        {
+            continue;
+        }
+        LOGGER_INFO("prof %s: %lu/%lu/%lu ciclos", profiler_probe_name[i],
+                    stats.min, (uint32_t)(stats.sum / stats.count), stats.max);
+        LOGGER_INFO("prof %s: n=%lu p50<2^%lu p99<2^%lu", profiler_probe_name[i], stats.count,
+                    profiler_percentile_bin_(&stats, 50), profiler_percentile_bin_(&stats, 99));
+    }
+}
+
+/********************** end of file ******************************************/
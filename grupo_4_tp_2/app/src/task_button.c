@@ -46,18 +46,25 @@
 #include "cmsis_os.h"
 #include "board.h"
 #include "logger.h"
-#include "dwt.h"
+#include "timebase.h"
+#include "memory_pool.h"
+#include "profiler.h"
+#include "critical.h"
 
 #include "ao_ui.h"
+#include "button_engine.h"
+#include "task_button.h"
 
 /********************** macros and definitions *******************************/
 
-#define TASK_PERIOD_MS_           (50)
+#define LOGGER_MODULE            BUTTON
 
-#define BUTTON_PERIOD_MS_         (TASK_PERIOD_MS_)
-#define BUTTON_PULSE_TIMEOUT_     (200)
-#define BUTTON_SHORT_TIMEOUT_     (1000)
-#define BUTTON_LONG_TIMEOUT_      (2000)
+// Los flancos se estampan con el timebase (us): pulsaciones de hasta ~71 min
+#define BUTTON_TICKS_PER_MS_      (TIMEBASE_HZ / 1000)
+#define BUTTON_DEBOUNCE_WAIT_     (pdMS_TO_TICKS(BUTTON_ENGINE_DEBOUNCE_MS) + 1)
+
+// (solo en modo por puntero)
+#define UI_MESSAGE_POOL_SIZE_     (AO_UI_QUEUE_LENGTH + 1)
 
 /********************** internal data declaration ****************************/
 
@@ -65,106 +72,146 @@
 
 /********************** internal data definition *****************************/
 
+#if (0 == AO_UI_CONFIG_BY_VALUE)
+MEMORY_POOL_STORAGE(ui_message_storage_, ao_ui_message_t, UI_MESSAGE_POOL_SIZE_);
+static memory_pool_t ui_message_pool_;
+#endif
+
+static button_engine_t button_engine_;
+static TaskHandle_t button_htask_ = NULL;
+
 /********************** external data definition *****************************/
 
 extern QueueHandle_t hqueue;
 
 /********************** internal functions definition ************************/
 
-typedef enum
+static bool button_read_pressed_(void)
 {
-	BUTTON_TYPE_NONE,
-	BUTTON_TYPE_PULSE,
-	BUTTON_TYPE_SHORT,
-	BUTTON_TYPE_LONG,
-	BUTTON_TYPE__N,
-} button_type_t;
-
-static struct
-{
-	uint32_t counter;
-} button;
+	return (BTN_PRESSED == HAL_GPIO_ReadPin(BTN_PORT, BTN_PIN));
+}
 
 static void button_init_(void)
 {
-	button.counter = 0;
+#if (0 == AO_UI_CONFIG_BY_VALUE)
+	MEMORY_POOL_INIT(&ui_message_pool_, ui_message_storage_);
+#endif
+
+	taskENTER_CRITICAL();
+	button_engine_init(&button_engine_, BUTTON_TICKS_PER_MS_, BUTTON_ENGINE_DEBOUNCE_MS, button_read_pressed_());
+	button_htask_ = xTaskGetCurrentTaskHandle();
+	taskEXIT_CRITICAL();
 }
 
-static button_type_t button_process_state_(bool value)
+static void button_stamp_(latency_stamp_t* pstamp, uint32_t edge_time)
 {
-	button_type_t ret = BUTTON_TYPE_NONE;
-	if(value)
-	{
-		button.counter += BUTTON_PERIOD_MS_;
-	}
-	else
+	latency_stamp_clear(pstamp);
+	latency_stamp_at(pstamp, LATENCY_HOP_EDGE, edge_time);
+	latency_stamp(pstamp, LATENCY_HOP_DETECT);
+}
+
+#if (1 == AO_UI_CONFIG_BY_VALUE)
+static void button_send_event_(ao_ui_action_t action, uint32_t edge_time)
+{
+	// El evento se copia en la cola: no hay memoria que devolver
+	ao_ui_message_t msg = {.callback = NULL, .action = action, .payload = NULL};
+	button_stamp_(&msg.stamp, edge_time);
+	if (!ao_ui_send_event(&msg))
 	{
-		if(BUTTON_LONG_TIMEOUT_ <= button.counter)
-		{
-			LOGGER_INFO("Se detecto BUTTON_TYPE_LONG");
-			ret = BUTTON_TYPE_LONG;
-		}
-		else if(BUTTON_SHORT_TIMEOUT_ <= button.counter)
-		{
-			LOGGER_INFO("Se detecto BUTTON_TYPE_SHORT");
-			ret = BUTTON_TYPE_SHORT;
-		}
-		else if(BUTTON_PULSE_TIMEOUT_ <= button.counter)
-		{
-			LOGGER_INFO("Se detecto BUTTON_TYPE_PULSE");
-			ret = BUTTON_TYPE_PULSE;
-		}
-		button.counter = 0;
+		LOGGER_WARN("No se pudo enviar %s", button_action_name[action]);
 	}
-	return ret;
 }
-
+#else
 static void callback_task_button(void *pmsg)
 {
 	ao_ui_message_t *msg = (ao_ui_message_t *)pmsg;
-	LOGGER_INFO("Liberando memoria de %s", button_action_name[msg->action]);
-	vPortFree(pmsg);
+	LOGGER_DEBUG_M(MEMORY, "Liberando memoria de %s", button_action_name[msg->action]);
+	memory_pool_block_put(&ui_message_pool_, pmsg);
 }
 
+static void button_send_event_(ao_ui_action_t action, uint32_t edge_time)
+{
+	LOGGER_DEBUG_M(MEMORY, "Creando %s", button_action_name[action]);
+	ao_ui_message_t* pmsg = MEMORY_POOL_GET(&ui_message_pool_, ao_ui_message_t);
+	if (NULL == pmsg)
+	{
+		LOGGER_WARN("Pool %s agotado", ui_message_pool_.name);
+		return;
+	}
+
+	pmsg->action = action;
+	pmsg->callback = callback_task_button;
+	pmsg->payload = NULL;
+	button_stamp_(&pmsg->stamp, edge_time);
+	if (!ao_ui_send_event(pmsg))
+	{
+		LOGGER_WARN("No se pudo enviar %s", button_action_name[action]);
+		memory_pool_block_put(&ui_message_pool_, pmsg);
+	}
+}
+#endif
+
 /********************** external functions definition ************************/
+/* EXTI del pulsador, ambos flancos (HAL_GPIO_EXTI_Callback) */
+void button_exti_isr(uint16_t pin)
+{
+	if ((BTN_PIN != pin) || (NULL == button_htask_))
+	{
+		return;
+	}
+
+	PROFILER_BEGIN(PROFILER_PROBE_BUTTON_ISR);
+	BaseType_t higher_priority_task_woken = pdFALSE;
+	UBaseType_t status = CRITICAL_ENTER_FROM_ISR(CRITICAL_SITE_BUTTON_ISR);
+	button_engine_edge(&button_engine_, timebase_us32(), button_read_pressed_());
+	CRITICAL_EXIT_FROM_ISR(status);
+
+	vTaskNotifyGiveFromISR(button_htask_, &higher_priority_task_woken);
+	PROFILER_END(PROFILER_PROBE_BUTTON_ISR);
+	portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
 void task_button(void* argument)
 {
 	button_init_();
 
 	while(true)
 	{
-		GPIO_PinState button_state;
-		button_state = HAL_GPIO_ReadPin(BTN_PORT, BTN_PIN);
-
 		button_type_t button_type;
-		button_type = button_process_state_(button_state);
+		uint32_t edge_time;
+		bool pending;
+
+		PROFILER_BEGIN(PROFILER_PROBE_BUTTON_ENGINE);
+		CRITICAL_ENTER(CRITICAL_SITE_BUTTON_POLL);
+		button_type = button_engine_poll(&button_engine_, timebase_us32());
+		pending = button_engine_pending(&button_engine_);
+		edge_time = button_engine_.release_time;
+		CRITICAL_EXIT();
+		PROFILER_END(PROFILER_PROBE_BUTTON_ENGINE);
 
 		switch (button_type) {
 			case BUTTON_TYPE_NONE:
 				break;
 			case BUTTON_TYPE_PULSE:
+				LOGGER_INFO("Se detecto BUTTON_TYPE_PULSE");
+				button_send_event_((ao_ui_action_t)button_type, edge_time);
+				break;
 			case BUTTON_TYPE_SHORT:
+				LOGGER_INFO("Se detecto BUTTON_TYPE_SHORT");
+				button_send_event_((ao_ui_action_t)button_type, edge_time);
+				break;
 			case BUTTON_TYPE_LONG:
-				LOGGER_INFO("Creando %s", button_action_name[(ao_ui_action_t)button_type]);
-				ao_ui_message_t* pmsg = (ao_ui_message_t*)pvPortMalloc(sizeof(ao_ui_message_t));
-				if (NULL != pmsg)
-				{
-					pmsg->action = (ao_ui_action_t)button_type;
-					pmsg->callback = callback_task_button;
-
-					if (!ao_ui_send_event(pmsg))
-					{
-						LOGGER_INFO("No se pudo enviar %s", button_action_name[pmsg->action]);
-						vPortFree(pmsg);
-					}
-				}
+				LOGGER_INFO("Se detecto BUTTON_TYPE_LONG");
+				button_send_event_((ao_ui_action_t)button_type, edge_time);
 				break;
 			default:
-				LOGGER_INFO("button error");
+				LOGGER_ERROR("button error");
 				break;
 		}
 
-		vTaskDelay(pdMS_TO_TICKS(TASK_PERIOD_MS_));
+		// Con un flanco sin confirmar espera el antirrebote; si no, duerme
+		// hasta el proximo flanco
+		(void)ulTaskNotifyTake(pdTRUE, pending ? BUTTON_DEBOUNCE_WAIT_ : portMAX_DELAY);
 	}
 }
 
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : tickless.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+#include "timebase.h"
+#include "profiler.h"
+
+#include "tickless.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+#define CYCLES_PER_TICK_         (SystemCoreClock / configTICK_RATE_HZ)
+#define US_PER_TICK_             (TIMEBASE_HZ / configTICK_RATE_HZ)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static tickless_stats_t stats_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Completa el tick en curso en 'cycles' y deja el periodo normal para los
+ * siguientes (LOAD se relee recien en la proxima recarga) */
+static void tickless_systick_restart_(uint32_t cycles)
+{
+    SysTick->LOAD = ((0 < cycles) ? cycles : 1) - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = CYCLES_PER_TICK_ - 1;
+}
+
+/********************** external functions definition ************************/
+
+void tickless_get_stats(tickless_stats_t* pstats)
+{
+    taskENTER_CRITICAL();
+    *pstats = stats_;
+    taskEXIT_CRITICAL();
+}
+
+void tickless_report(void)
+{
+    tickless_stats_t stats;
+    tickless_get_stats(&stats);
+    LOGGER_INFO("tickless: %lu sleeps (%lu abortados) %lu ticks %lu ms", stats.sleeps, stats.aborted,
+                stats.ticks_slept, (uint32_t)(stats.slept_us / 1000));
+    LOGGER_INFO("tickless: despertar %lu ciclos (max %lu)", stats.wake_cycles_last, stats.wake_cycles_max);
+}
+
+/* portSUPPRESS_TICKS_AND_SLEEP, desde la tarea idle con el scheduler
+ * suspendido. Se usa PRIMASK y no taskENTER_CRITICAL para que cualquier IRQ
+ * pueda sacar al nucleo del WFI; la ISR corre recien con el tick corregido */
+void tickless_sleep_(uint32_t expected_idle_ticks)
+{
+    if (expected_idle_ticks > TICKLESS_CONFIG_MAX_IDLE_TICKS)
+    {
+        expected_idle_ticks = TICKLESS_CONFIG_MAX_IDLE_TICKS;
+    }
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (eAbortSleep == eTaskConfirmSleepModeStatus())
+    {
+        stats_.aborted++;
+        __enable_irq();
+        return;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    uint32_t start = timebase_us32();
+    uint32_t left_us = SysTick->VAL / cycles_per_us;
+
+    // El tick vencio mientras se detenia SysTick: lo atiende su ISR
+    if (0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        stats_.aborted++;
+        __enable_irq();
+        return;
+    }
+
+    // Despertador: resto del tick en curso + los ticks ociosos siguientes
+    uint32_t sleep_us = left_us + ((expected_idle_ticks - 1) * US_PER_TICK_);
+    TIMEBASE_TIM->CCR1 = start + sleep_us;
+    TIMEBASE_TIM->SR = (uint32_t)~TIM_SR_CC1IF;
+    TIMEBASE_TIM->DIER |= TIM_DIER_CC1IE;
+
+    if ((int32_t)(TIMEBASE_TIM->CCR1 - timebase_us32()) > 0)
+    {
+        __DSB();
+        __WFI();
+        __ISB();
+    }
+    uint32_t wake = cycle_counter_get();
+
+    TIMEBASE_TIM->DIER &= ~TIM_DIER_CC1IE;
+    TIMEBASE_TIM->SR = (uint32_t)~TIM_SR_CC1IF;
+
+    // Ticks completos segun TIM2 y fase del proximo tick
+    uint32_t elapsed_us = timebase_us32() - start;
+    uint32_t ticks;
+    uint32_t next_us;
+    if (elapsed_us < left_us)
+    {
+        ticks = 0;
+        next_us = left_us - elapsed_us;
+    }
+    else
+    {
+        uint32_t over_us = elapsed_us - left_us;
+        ticks = 1 + (over_us / US_PER_TICK_);
+        next_us = US_PER_TICK_ - (over_us % US_PER_TICK_);
+    }
+
+    // El ultimo tick lo procesa la ISR de SysTick para desbloquear a tiempo
+    if (ticks >= expected_idle_ticks)
+    {
+        ticks = expected_idle_ticks - 1;
+        next_us = 1;
+    }
+
+    tickless_systick_restart_(next_us * cycles_per_us);
+    vTaskStepTick(ticks);
+
+    stats_.sleeps++;
+    stats_.ticks_expected += expected_idle_ticks;
+    stats_.ticks_slept += ticks;
+    stats_.slept_us += elapsed_us;
+
+    // La IRQ que desperto al nucleo se atiende aca
+    __enable_irq();
+    __ISB();
+
+    uint32_t wake_cycles = cycle_counter_elapsed(wake);
+    stats_.wake_cycles_last = wake_cycles;
+    if (wake_cycles > stats_.wake_cycles_max)
+    {
+        stats_.wake_cycles_max = wake_cycles;
+    }
+    profiler_record(PROFILER_PROBE_TICKLESS_WAKE, wake_cycles);
+}
+
+/********************** end of file ******************************************/
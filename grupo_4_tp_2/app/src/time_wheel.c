@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : time_wheel.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "time_wheel.h"
+
+/********************** macros and definitions *******************************/
+
+#define SLOT_MASK_               (TIME_WHEEL_SLOTS - 1)
+#define LEVEL_SHIFT_(level)      (TIME_WHEEL_LEVEL_BITS * (level))
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+static uint64_t rotate_right_(uint64_t value, uint32_t n)
+{
+	return (0 == n) ? value : ((value >> n) | (value << (64 - n)));
+}
+
+static void time_wheel_link_(time_wheel_t* pwheel, time_wheel_timer_t* ptimer, uint32_t level, uint32_t slot)
+{
+	time_wheel_timer_t** phead = &pwheel->slot[level][slot];
+
+	ptimer->next = *phead;
+	if (NULL != ptimer->next)
+	{
+		ptimer->next->pprev = &ptimer->next;
+	}
+	*phead = ptimer;
+	ptimer->pprev = phead;
+	ptimer->level = (uint8_t)level;
+	ptimer->slot = (uint8_t)slot;
+	pwheel->occupied[level] |= (1ULL << slot);
+}
+
+static void time_wheel_unlink_(time_wheel_t* pwheel, time_wheel_timer_t* ptimer)
+{
+	*ptimer->pprev = ptimer->next;
+	if (NULL != ptimer->next)
+	{
+		ptimer->next->pprev = ptimer->pprev;
+	}
+	if (NULL == pwheel->slot[ptimer->level][ptimer->slot])
+	{
+		pwheel->occupied[ptimer->level] &= ~(1ULL << ptimer->slot);
+	}
+	ptimer->next = NULL;
+	ptimer->pprev = NULL;
+}
+
+/* Nivel mas bajo cuyo rango cubre la distancia al vencimiento. Lo vencido va a
+ * la ranura del proximo tick */
+static void time_wheel_place_(time_wheel_t* pwheel, time_wheel_timer_t* ptimer)
+{
+	uint32_t delta = ptimer->expires - pwheel->now;
+
+	if ((int32_t)delta < 0)
+	{
+		time_wheel_link_(pwheel, ptimer, 0, pwheel->now & SLOT_MASK_);
+		return;
+	}
+
+	uint32_t level = 0;
+	while ((level < (TIME_WHEEL_LEVELS - 1)) && (delta >= (1UL << LEVEL_SHIFT_(level + 1))))
+	{
+		level++;
+	}
+	time_wheel_link_(pwheel, ptimer, level, (ptimer->expires >> LEVEL_SHIFT_(level)) & SLOT_MASK_);
+}
+
+/* Con el nivel 0 en la ranura 0 se redistribuye la ranura actual del nivel 1;
+ * si esta tambien dio la vuelta, la del nivel 2, y asi. Cada timer baja a lo
+ * sumo TIME_WHEEL_LEVELS - 1 veces en toda su vida */
+static void time_wheel_cascade_(time_wheel_t* pwheel)
+{
+	for (uint32_t level = 1; level < TIME_WHEEL_LEVELS; level++)
+	{
+		uint32_t index = (pwheel->now >> LEVEL_SHIFT_(level)) & SLOT_MASK_;
+		time_wheel_timer_t* ptimer = pwheel->slot[level][index];
+
+		pwheel->slot[level][index] = NULL;
+		pwheel->occupied[level] &= ~(1ULL << index);
+		while (NULL != ptimer)
+		{
+			time_wheel_timer_t* pnext = ptimer->next;
+			time_wheel_place_(pwheel, ptimer);
+			pwheel->cascaded++;
+			ptimer = pnext;
+		}
+
+		if (0 != index)
+		{
+			break;
+		}
+	}
+}
+
+/********************** external functions definition ************************/
+
+void time_wheel_init(time_wheel_t* pwheel, uint32_t now)
+{
+	pwheel->now = now;
+	pwheel->count = 0;
+	pwheel->cascaded = 0;
+	for (uint32_t level = 0; level < TIME_WHEEL_LEVELS; level++)
+	{
+		pwheel->occupied[level] = 0;
+		for (uint32_t slot = 0; slot < TIME_WHEEL_SLOTS; slot++)
+		{
+			pwheel->slot[level][slot] = NULL;
+		}
+	}
+}
+
+void time_wheel_timer_init(time_wheel_timer_t* ptimer, time_wheel_cb_t callback)
+{
+	ptimer->next = NULL;
+	ptimer->pprev = NULL;
+	ptimer->expires = 0;
+	ptimer->period = 0;
+	ptimer->level = 0;
+	ptimer->slot = 0;
+	ptimer->callback = callback;
+}
+
+/* Arma o rearma en O(1). expires es absoluto; period en ticks, 0 un disparo.
+ * Los periodicos se rearman desde el vencimiento anterior, sin deriva */
+bool time_wheel_arm(time_wheel_t* pwheel, time_wheel_timer_t* ptimer, uint32_t expires, uint32_t period)
+{
+	uint32_t delta = expires - pwheel->now;
+
+	if ((NULL == ptimer->callback) || (period > TIME_WHEEL_MAX_DELAY)
+			|| (((int32_t)delta >= 0) && (delta > TIME_WHEEL_MAX_DELAY)))
+	{
+		return false;
+	}
+
+	if ((int32_t)delta < 0)
+	{
+		// Ya vencido: dispara en el proximo tick y el periodo cuenta desde ahi
+		expires = pwheel->now;
+	}
+
+	if (time_wheel_is_armed(ptimer))
+	{
+		time_wheel_unlink_(pwheel, ptimer);
+	}
+	else
+	{
+		pwheel->count++;
+	}
+	ptimer->expires = expires;
+	ptimer->period = period;
+	time_wheel_place_(pwheel, ptimer);
+	return true;
+}
+
+bool time_wheel_cancel(time_wheel_t* pwheel, time_wheel_timer_t* ptimer)
+{
+	if (!time_wheel_is_armed(ptimer))
+	{
+		return false;
+	}
+	time_wheel_unlink_(pwheel, ptimer);
+	pwheel->count--;
+	return true;
+}
+
+bool time_wheel_is_armed(const time_wheel_timer_t* ptimer)
+{
+	return (NULL != ptimer->pprev);
+}
+
+/* Procesa los ticks hasta until inclusive y devuelve los vencimientos. Los
+ * ticks sin ranuras ocupadas se saltan con el bitmap, asi que el costo depende
+ * de los timers vencidos y de las vueltas del nivel 0, no del tiempo dormido.
+ * El callback puede rearmar o cancelar cualquier timer */
+uint32_t time_wheel_advance(time_wheel_t* pwheel, uint32_t until)
+{
+	uint32_t expired = 0;
+
+	if (0 == pwheel->count)
+	{
+		pwheel->now = until + 1;
+		return 0;
+	}
+
+	while ((int32_t)(until - pwheel->now) >= 0)
+	{
+		uint32_t index = pwheel->now & SLOT_MASK_;
+		if (0 == index)
+		{
+			time_wheel_cascade_(pwheel);
+		}
+
+		// Se saca la lista de la ranura antes de correr los callbacks
+		time_wheel_timer_t* pending = pwheel->slot[0][index];
+		pwheel->slot[0][index] = NULL;
+		pwheel->occupied[0] &= ~(1ULL << index);
+		if (NULL != pending)
+		{
+			pending->pprev = &pending;
+		}
+		pwheel->now++;
+
+		while (NULL != pending)
+		{
+			time_wheel_timer_t* ptimer = pending;
+			time_wheel_unlink_(pwheel, ptimer);
+			if (0 != ptimer->period)
+			{
+				ptimer->expires += ptimer->period;
+				time_wheel_place_(pwheel, ptimer);
+			}
+			else
+			{
+				pwheel->count--;
+			}
+			ptimer->callback(ptimer);
+			expired++;
+		}
+
+		// Ticks vacios hasta la proxima ranura ocupada o la proxima vuelta
+		index = pwheel->now & SLOT_MASK_;
+		if ((0 != index) && ((int32_t)(until - pwheel->now) >= 0))
+		{
+			uint64_t ahead = pwheel->occupied[0] >> index;
+			uint32_t gap = (0 != ahead) ? (uint32_t)__builtin_ctzll(ahead) : (TIME_WHEEL_SLOTS - index);
+			uint32_t left = until - pwheel->now + 1;
+			pwheel->now += (gap < left) ? gap : left;
+		}
+	}
+	return expired;
+}
+
+/* Ticks desde now hasta el proximo tick que hay que procesar: un vencimiento
+ * del nivel 0 o el descenso de una ranura ocupada de un nivel superior */
+uint32_t time_wheel_next(const time_wheel_t* pwheel)
+{
+	uint32_t next = TIME_WHEEL_NONE;
+
+	for (uint32_t level = 0; level < TIME_WHEEL_LEVELS; level++)
+	{
+		if (0 == pwheel->occupied[level])
+		{
+			continue;
+		}
+
+		// Primera vuelta de este nivel que empieza en now o despues
+		uint32_t shift = LEVEL_SHIFT_(level);
+		uint32_t round = (pwheel->now >> shift) + ((0 != (pwheel->now & ((1UL << shift) - 1))) ? 1 : 0);
+		uint64_t ahead = rotate_right_(pwheel->occupied[level], round & SLOT_MASK_);
+		uint32_t ticks = ((round + (uint32_t)__builtin_ctzll(ahead)) << shift) - pwheel->now;
+
+		if (ticks < next)
+		{
+			next = ticks;
+		}
+	}
+	return next;
+}
+
+/********************** end of file ******************************************/
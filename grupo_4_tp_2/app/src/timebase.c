@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : timebase.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+
+#include "timebase.h"
+
+/********************** macros and definitions *******************************/
+
+#define TIMEBASE_HALF_RANGE_     (0x80000000UL)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static volatile uint32_t high_;         // desbordes de TIM2 atendidos
+static uint64_t base_us_;               // continuidad con uwTick al arrancar
+static volatile bool running_ = false;
+
+/********************** external data definition *****************************/
+
+extern TIM_HandleTypeDef htim2;
+
+/********************** internal functions definition ************************/
+
+/********************** external functions definition ************************/
+
+/* TIM2 ya esta configurado por MX_TIM2_Init (PSC = 84 - 1, ARR = 0xFFFFFFFF).
+ * El reloj arranca en el valor de HAL_GetTick() para que el tick del HAL no
+ * retroceda al cambiar de fuente */
+void timebase_init(void)
+{
+    base_us_ = (uint64_t)HAL_GetTick() * 1000;
+    high_ = 0;
+
+    // HAL_TIM_Base_Init deja UIF en 1 por el UG de la carga del prescaler
+    TIMEBASE_TIM->SR = (uint32_t)~TIM_SR_UIF;
+    __HAL_TIM_SET_COUNTER(&htim2, 0);
+    HAL_TIM_Base_Start_IT(&htim2);
+    running_ = true;
+}
+
+bool timebase_is_running(void)
+{
+    return running_;
+}
+
+/* Desde tareas o ISR con prioridad menor o igual a la de TIM2. Si el desborde
+ * esta pendiente (IRQ enmascarada) se corrige con UIF: un CNT chico con UIF en
+ * 1 ya pertenece a la vuelta siguiente */
+uint64_t timebase_us(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t high = high_;
+    uint32_t low = TIMEBASE_TIM->CNT;
+    if ((0 != (TIMEBASE_TIM->SR & TIM_SR_UIF)) && (low < TIMEBASE_HALF_RANGE_))
+    {
+        high++;
+    }
+    __set_PRIMASK(primask);
+
+    return base_us_ + (((uint64_t)high << 32) | low);
+}
+
+uint32_t timebase_ms(void)
+{
+    return (uint32_t)(timebase_us() / 1000);
+}
+
+/* HAL_TIM_PeriodElapsedCallback: TIM2 solo interrumpe al desbordar */
+void timebase_period_elapsed_isr(TIM_HandleTypeDef* htim)
+{
+    if (TIMEBASE_TIM == htim->Instance)
+    {
+        high_++;
+    }
+}
+
+/* El tick del HAL sale del timebase; antes de timebase_init() sigue contando
+ * uwTick desde SysTick */
+uint32_t HAL_GetTick(void)
+{
+    return running_ ? timebase_ms() : uwTick;
+}
+
+/********************** end of file ******************************************/
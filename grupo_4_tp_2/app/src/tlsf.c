@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : tlsf.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "tlsf.h"
+
+/********************** macros and definitions *******************************/
+
+#define HEADER_SIZE_             (offsetof(tlsf_block_t, next_free))
+#define BLOCK_MIN_               (ALIGN_UP_(sizeof(tlsf_block_t) - HEADER_SIZE_))
+#define BLOCK_MAX_               ((size_t)1 << TLSF_CONFIG_FL_MAX)
+#define SMALL_BLOCK_             ((size_t)1 << TLSF_FL_SHIFT)
+#define FREE_BIT_                ((size_t)1)
+
+#define ALIGN_UP_(x)             (((x) + (TLSF_ALIGN - 1)) & ~(size_t)(TLSF_ALIGN - 1))
+
+/* Una operacion sobre listas o bitmaps. tools/tlsf_test.c la cuenta para
+ * acotar los pasos de malloc y free; en el firmware no genera codigo */
+#ifndef TLSF_STEP
+#define TLSF_STEP()
+#endif
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Indice del bit mas significativo / menos significativo (CLZ y RBIT+CLZ en
+ * el M4: tiempo constante) */
+static uint32_t fls_(size_t x)
+{
+	return (uint32_t)((sizeof(unsigned long) * 8) - 1 - (uint32_t)__builtin_clzl((unsigned long)x));
+}
+
+static uint32_t ffs_(uint32_t x)
+{
+	return (uint32_t)__builtin_ctz(x);
+}
+
+static size_t block_size_(const tlsf_block_t* pblock)
+{
+	return pblock->size & ~FREE_BIT_;
+}
+
+static bool block_is_free_(const tlsf_block_t* pblock)
+{
+	return 0 != (pblock->size & FREE_BIT_);
+}
+
+static void* block_to_ptr_(tlsf_block_t* pblock)
+{
+	return (uint8_t*)pblock + HEADER_SIZE_;
+}
+
+static tlsf_block_t* ptr_to_block_(const void* ptr)
+{
+	return (tlsf_block_t*)((uint8_t*)ptr - HEADER_SIZE_);
+}
+
+static tlsf_block_t* block_next_(tlsf_block_t* pblock)
+{
+	return (tlsf_block_t*)((uint8_t*)block_to_ptr_(pblock) + block_size_(pblock));
+}
+
+/* Clase (fl, sl) a la que pertenece un bloque de size bytes */
+static void mapping_insert_(size_t size, uint32_t* pfl, uint32_t* psl)
+{
+	if (size < SMALL_BLOCK_)
+	{
+		*pfl = 0;
+		*psl = (uint32_t)(size / (SMALL_BLOCK_ / TLSF_SL_COUNT));
+	}
+	else
+	{
+		uint32_t fl = fls_(size);
+		*psl = (uint32_t)(size >> (fl - TLSF_CONFIG_SL_LOG2)) ^ TLSF_SL_COUNT;
+		*pfl = fl - (TLSF_FL_SHIFT - 1);
+	}
+}
+
+/* Clase desde la que cualquier bloque sirve: se redondea size al inicio de
+ * la clase siguiente (good fit, sin recorrer la lista) */
+static void mapping_search_(size_t size, uint32_t* pfl, uint32_t* psl)
+{
+	if (size >= SMALL_BLOCK_)
+	{
+		size += ((size_t)1 << (fls_(size) - TLSF_CONFIG_SL_LOG2)) - 1;
+	}
+	mapping_insert_(size, pfl, psl);
+}
+
+static tlsf_block_t* search_suitable_(const tlsf_t* ptlsf, uint32_t* pfl, uint32_t* psl)
+{
+	uint32_t fl = *pfl;
+	uint32_t sl_map = ptlsf->sl_bitmap[fl] & (~(uint32_t)0 << *psl);
+
+	TLSF_STEP();
+
+	if (0 == sl_map)
+	{
+		uint32_t fl_map = (fl + 1 < 32) ? (ptlsf->fl_bitmap & (~(uint32_t)0 << (fl + 1))) : 0;
+		if (0 == fl_map)
+		{
+			return NULL;
+		}
+		fl = ffs_(fl_map);
+		sl_map = ptlsf->sl_bitmap[fl];
+	}
+
+	*pfl = fl;
+	*psl = ffs_(sl_map);
+	return ptlsf->free_list[fl][*psl];
+}
+
+static void free_remove_(tlsf_t* ptlsf, tlsf_block_t* pblock, uint32_t fl, uint32_t sl)
+{
+	TLSF_STEP();
+	if (NULL != pblock->next_free)
+	{
+		pblock->next_free->prev_free = pblock->prev_free;
+	}
+	if (NULL != pblock->prev_free)
+	{
+		pblock->prev_free->next_free = pblock->next_free;
+	}
+	else
+	{
+		ptlsf->free_list[fl][sl] = pblock->next_free;
+		if (NULL == pblock->next_free)
+		{
+			ptlsf->sl_bitmap[fl] &= ~(1UL << sl);
+			if (0 == ptlsf->sl_bitmap[fl])
+			{
+				ptlsf->fl_bitmap &= ~(1UL << fl);
+			}
+		}
+	}
+	ptlsf->free_blocks--;
+	ptlsf->free -= block_size_(pblock);
+}
+
+static void free_remove_block_(tlsf_t* ptlsf, tlsf_block_t* pblock)
+{
+	uint32_t fl, sl;
+	mapping_insert_(block_size_(pblock), &fl, &sl);
+	free_remove_(ptlsf, pblock, fl, sl);
+}
+
+static void free_insert_(tlsf_t* ptlsf, tlsf_block_t* pblock)
+{
+	uint32_t fl, sl;
+	mapping_insert_(block_size_(pblock), &fl, &sl);
+
+	TLSF_STEP();
+	pblock->size |= FREE_BIT_;
+	pblock->prev_free = NULL;
+	pblock->next_free = ptlsf->free_list[fl][sl];
+	if (NULL != pblock->next_free)
+	{
+		pblock->next_free->prev_free = pblock;
+	}
+	ptlsf->free_list[fl][sl] = pblock;
+	ptlsf->fl_bitmap |= (1UL << fl);
+	ptlsf->sl_bitmap[fl] |= (1UL << sl);
+	ptlsf->free_blocks++;
+	ptlsf->free += block_size_(pblock);
+}
+
+/* Deja size bytes en pblock y devuelve el resto como bloque libre, si entra
+ * una cabecera y un bloque minimo */
+static void block_trim_(tlsf_t* ptlsf, tlsf_block_t* pblock, size_t size)
+{
+	size_t total = block_size_(pblock);
+	if (total < (size + HEADER_SIZE_ + BLOCK_MIN_))
+	{
+		return;
+	}
+
+	tlsf_block_t* prest = (tlsf_block_t*)((uint8_t*)block_to_ptr_(pblock) + size);
+	prest->prev_phys = pblock;
+	prest->size = total - size - HEADER_SIZE_;
+	block_next_(prest)->prev_phys = prest;
+	pblock->size = size | (pblock->size & FREE_BIT_);
+	free_insert_(ptlsf, prest);
+}
+
+/* Une pblock con el siguiente (libre y ya fuera de su lista) */
+static void block_absorb_(tlsf_block_t* pblock, tlsf_block_t* pnext)
+{
+	TLSF_STEP();
+	pblock->size += block_size_(pnext) + HEADER_SIZE_;
+	block_next_(pblock)->prev_phys = pblock;
+}
+
+/********************** external functions definition ************************/
+
+/* El bloque inicial ocupa toda la memoria menos dos cabeceras: la propia y la
+ * de un bloque final de tamano 0, siempre ocupado, que corta la union */
+bool tlsf_init(tlsf_t* ptlsf, void* memory, size_t bytes)
+{
+	uintptr_t start = ALIGN_UP_((uintptr_t)memory);
+	size_t usable = (bytes - (size_t)(start - (uintptr_t)memory)) & ~(size_t)(TLSF_ALIGN - 1);
+
+	for (uint32_t fl = 0; fl < TLSF_FL_COUNT; fl++)
+	{
+		ptlsf->sl_bitmap[fl] = 0;
+		for (uint32_t sl = 0; sl < TLSF_SL_COUNT; sl++)
+		{
+			ptlsf->free_list[fl][sl] = NULL;
+		}
+	}
+	ptlsf->fl_bitmap = 0;
+	ptlsf->free_blocks = 0;
+	ptlsf->allocs = 0;
+	ptlsf->frees = 0;
+	ptlsf->failed = 0;
+	ptlsf->first = NULL;
+	ptlsf->size = 0;
+	ptlsf->free = 0;
+	ptlsf->free_min = 0;
+
+	if ((bytes <= (size_t)(start - (uintptr_t)memory)) || (usable < (2 * HEADER_SIZE_ + BLOCK_MIN_)) ||
+		((usable - 2 * HEADER_SIZE_) >= BLOCK_MAX_))
+	{
+		return false;
+	}
+
+	tlsf_block_t* pblock = (tlsf_block_t*)start;
+	pblock->prev_phys = NULL;
+	pblock->size = usable - 2 * HEADER_SIZE_;
+	tlsf_block_t* pend = block_next_(pblock);
+	pend->prev_phys = pblock;
+	pend->size = 0;
+	free_insert_(ptlsf, pblock);
+
+	ptlsf->first = pblock;
+	ptlsf->size = block_size_(pblock);
+	ptlsf->free_min = ptlsf->free;
+	return true;
+}
+
+void* tlsf_malloc(tlsf_t* ptlsf, size_t size)
+{
+	if ((0 == size) || (size >= BLOCK_MAX_))
+	{
+		ptlsf->failed++;
+		return NULL;
+	}
+	size = ALIGN_UP_(size);
+	if (size < BLOCK_MIN_)
+	{
+		size = BLOCK_MIN_;
+	}
+
+	uint32_t fl, sl;
+	mapping_search_(size, &fl, &sl);
+	tlsf_block_t* pblock = (fl < TLSF_FL_COUNT) ? search_suitable_(ptlsf, &fl, &sl) : NULL;
+	if (NULL == pblock)
+	{
+		// Sin clases mayores: la cabeza de la propia clase puede alcanzar, asi
+		// un pedido de hasta largest_alloc no falla por el redondeo
+		TLSF_STEP();
+		mapping_insert_(size, &fl, &sl);
+		pblock = ptlsf->free_list[fl][sl];
+		if ((NULL == pblock) || (block_size_(pblock) < size))
+		{
+			ptlsf->failed++;
+			return NULL;
+		}
+	}
+
+	free_remove_(ptlsf, pblock, fl, sl);
+	pblock->size &= ~FREE_BIT_;
+	block_trim_(ptlsf, pblock, size);
+
+	if (ptlsf->free < ptlsf->free_min)
+	{
+		ptlsf->free_min = ptlsf->free;
+	}
+	ptlsf->allocs++;
+	return block_to_ptr_(pblock);
+}
+
+void tlsf_free(tlsf_t* ptlsf, void* ptr)
+{
+	if (NULL == ptr)
+	{
+		return;
+	}
+
+	tlsf_block_t* pblock = ptr_to_block_(ptr);
+	ptlsf->frees++;
+
+	// Une con los vecinos libres: cada union recupera una cabecera
+	tlsf_block_t* pprev = pblock->prev_phys;
+	if ((NULL != pprev) && block_is_free_(pprev))
+	{
+		free_remove_block_(ptlsf, pprev);
+		pprev->size &= ~FREE_BIT_;
+		block_absorb_(pprev, pblock);
+		pblock = pprev;
+	}
+	tlsf_block_t* pnext = block_next_(pblock);
+	if (block_is_free_(pnext))
+	{
+		free_remove_block_(ptlsf, pnext);
+		block_absorb_(pblock, pnext);
+	}
+
+	free_insert_(ptlsf, pblock);
+}
+
+/* Verificacion de vPortFree, como los configASSERT de heap_4: el puntero cae
+ * en un bloque de datos, ocupado y enlazado con su vecino fisico. Un doble
+ * free o un puntero ajeno no pasan */
+bool tlsf_is_allocated(const tlsf_t* ptlsf, const void* ptr)
+{
+	if ((NULL == ptlsf->first) || (0 != ((uintptr_t)ptr & (TLSF_ALIGN - 1))))
+	{
+		return false;
+	}
+
+	const uint8_t* pbegin = block_to_ptr_(ptlsf->first);
+	const uint8_t* pend = pbegin + ptlsf->size;     // cabecera del bloque final
+	if (((const uint8_t*)ptr < pbegin) || ((const uint8_t*)ptr >= pend))
+	{
+		return false;
+	}
+
+	tlsf_block_t* pblock = ptr_to_block_(ptr);
+	if (block_is_free_(pblock) || (0 == block_size_(pblock)) ||
+		((const uint8_t*)ptr + block_size_(pblock) > pend))
+	{
+		return false;
+	}
+	return block_next_(pblock)->prev_phys == pblock;
+}
+
+size_t tlsf_block_size(const void* ptr)
+{
+	return (NULL == ptr) ? 0 : block_size_(ptr_to_block_(ptr));
+}
+
+/* El mayor bloque esta en la clase no vacia mas alta y el menor en la mas
+ * baja; dentro de una clase los tamanos varian y se recorre esa unica lista
+ * (solo para estadisticas). El mayor pedido atendible es la cabeza de la clase
+ * mas alta: hasta ahi tlsf_malloc encuentra bloque, por redondeo o por la
+ * cabeza de la propia clase */
+void tlsf_get_stats(const tlsf_t* ptlsf, tlsf_stats_t* pstats)
+{
+	pstats->size = ptlsf->size;
+	pstats->free = ptlsf->free;
+	pstats->free_min = ptlsf->free_min;
+	pstats->free_blocks = ptlsf->free_blocks;
+	pstats->allocs = ptlsf->allocs;
+	pstats->frees = ptlsf->frees;
+	pstats->failed = ptlsf->failed;
+	pstats->largest_free = 0;
+	pstats->largest_alloc = 0;
+	pstats->smallest_free = 0;
+
+	if (0 != ptlsf->fl_bitmap)
+	{
+		uint32_t fl = fls_(ptlsf->fl_bitmap);
+		uint32_t sl = fls_(ptlsf->sl_bitmap[fl]);
+		pstats->largest_alloc = block_size_(ptlsf->free_list[fl][sl]);
+		for (const tlsf_block_t* pblock = ptlsf->free_list[fl][sl]; NULL != pblock; pblock = pblock->next_free)
+		{
+			if (block_size_(pblock) > pstats->largest_free)
+			{
+				pstats->largest_free = block_size_(pblock);
+			}
+		}
+
+		fl = ffs_(ptlsf->fl_bitmap);
+		sl = ffs_(ptlsf->sl_bitmap[fl]);
+		pstats->smallest_free = SIZE_MAX;
+		for (const tlsf_block_t* pblock = ptlsf->free_list[fl][sl]; NULL != pblock; pblock = pblock->next_free)
+		{
+			if (block_size_(pblock) < pstats->smallest_free)
+			{
+				pstats->smallest_free = block_size_(pblock);
+			}
+		}
+	}
+}
+
+/* Recorre la memoria y las listas y verifica que coincidan (bench y pruebas) */
+bool tlsf_check(const tlsf_t* ptlsf)
+{
+	uint32_t free_blocks = 0;
+	size_t free = 0;
+	tlsf_block_t* pprev = NULL;
+
+	if (NULL == ptlsf->first)
+	{
+		return false;
+	}
+	for (tlsf_block_t* pblock = ptlsf->first; 0 != block_size_(pblock); pblock = block_next_(pblock))
+	{
+		if ((pblock->prev_phys != pprev) || (0 != ((uintptr_t)block_to_ptr_(pblock) & (TLSF_ALIGN - 1))))
+		{
+			return false;
+		}
+		if (block_is_free_(pblock))
+		{
+			uint32_t fl, sl;
+			// Dos libres contiguos debieron unirse
+			if ((NULL != pprev) && block_is_free_(pprev))
+			{
+				return false;
+			}
+			mapping_insert_(block_size_(pblock), &fl, &sl);
+			const tlsf_block_t* pit = ptlsf->free_list[fl][sl];
+			while ((NULL != pit) && (pit != pblock))
+			{
+				pit = pit->next_free;
+			}
+			if (NULL == pit)
+			{
+				return false;
+			}
+			free_blocks++;
+			free += block_size_(pblock);
+		}
+		pprev = pblock;
+	}
+	return (free_blocks == ptlsf->free_blocks) && (free == ptlsf->free);
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : trace.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "dwt.h"
+
+#include "trace.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+#define RECORDS_MASK_            (TRACE_CONFIG_RECORDS - 1)
+#define CALIBRATION_RECORDS_     (16)
+
+#if (0 != (TRACE_CONFIG_RECORDS & RECORDS_MASK_))
+#error "TRACE_CONFIG_RECORDS debe ser potencia de 2"
+#endif
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+#if (1 == TRACE_CONFIG_ENABLE)
+static volatile bool running_ = false;
+static uint8_t current_task_;
+static uint32_t switched_out_;
+#endif
+
+/********************** external data definition *****************************/
+
+extern UART_HandleTypeDef huart2;
+
+#if (1 == TRACE_CONFIG_ENABLE)
+/* Simbolo para leer la captura con el debugger:
+ *   dump binary memory trace.bin &trace_dump_buffer (&trace_dump_buffer)+1 */
+trace_dump_t trace_dump_buffer;
+#endif
+
+/********************** internal functions definition ************************/
+
+#if (1 == TRACE_CONFIG_ENABLE)
+/* Costo acotado: sin lazos ni llamadas, con las IRQ enmascaradas unos pocos
+ * ciclos. Se puede llamar desde tareas, secciones criticas e ISR */
+static inline void trace_write_(uint8_t event, uint8_t task, uint16_t aux, uint32_t arg)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    {
+        trace_record_t* prec = &trace_dump_buffer.records[trace_dump_buffer.head & RECORDS_MASK_];
+        trace_dump_buffer.head++;
+        prec->timestamp = cycle_counter_get();
+        prec->event = event;
+        prec->task = task;
+        prec->aux = aux;
+        prec->arg = arg;
+    }
+    __set_PRIMASK(primask);
+}
+#endif
+
+/********************** external functions definition ************************/
+
+#if (1 == TRACE_CONFIG_ENABLE)
+
+void trace_init(void)
+{
+    memset(&trace_dump_buffer, 0, sizeof(trace_dump_buffer));
+    trace_dump_buffer.magic = TRACE_MAGIC;
+    trace_dump_buffer.version = TRACE_VERSION;
+    trace_dump_buffer.record_size = sizeof(trace_record_t);
+    trace_dump_buffer.capacity = TRACE_CONFIG_RECORDS;
+    trace_dump_buffer.clock_hz = SystemCoreClock;
+
+    // Calibracion del costo de un registro
+    running_ = true;
+    uint32_t t0 = cycle_counter_get();
+    for (uint32_t i = 0; i < CALIBRATION_RECORDS_; i++)
+    {
+        trace_event_(TRACE_EVENT_USER, 0, i);
+    }
+    uint32_t t1 = cycle_counter_get();
+    trace_dump_buffer.overhead_cycles = (t1 - t0) / CALIBRATION_RECORDS_;
+
+    trace_dump_buffer.head = 0;
+    memset(trace_dump_buffer.records, 0, sizeof(trace_dump_buffer.records));
+}
+
+void trace_start(void)
+{
+    running_ = true;
+}
+
+void trace_stop(void)
+{
+    running_ = false;
+}
+
+void trace_user(uint16_t aux, uint32_t arg)
+{
+    trace_event_(TRACE_EVENT_USER, aux, arg);
+}
+
+/* Detiene la captura y envia la imagen completa por huart2 en modo polling.
+ * Solo desde una tarea; el logger se vacia antes para no mezclar bytes */
+void trace_dump(void)
+{
+    trace_stop();
+    logger_flush();
+    HAL_UART_Transmit(&huart2, (uint8_t*)&trace_dump_buffer, sizeof(trace_dump_buffer), HAL_MAX_DELAY);
+}
+
+void trace_event_(uint8_t event, uint16_t aux, uint32_t arg)
+{
+    if (running_)
+    {
+        trace_write_(event, current_task_, aux, arg);
+    }
+}
+
+void trace_task_switched_out_(uint32_t task)
+{
+    switched_out_ = task;
+}
+
+/* vTaskSwitchContext llama a los dos hooks en cada tick: solo se registra
+ * cuando cambia la tarea */
+void trace_task_switched_in_(uint32_t task)
+{
+    if ((task != switched_out_) && running_)
+    {
+        trace_write_(TRACE_EVENT_TASK_SWITCH_OUT, (uint8_t)switched_out_, 0, switched_out_);
+        trace_write_(TRACE_EVENT_TASK_SWITCH_IN, (uint8_t)task, 0, task);
+    }
+    current_task_ = (uint8_t)task;
+}
+
+void trace_task_create_(uint32_t task, const char* name)
+{
+    uint32_t slot = task % TRACE_CONFIG_MAX_TASKS;
+    char* dst = trace_dump_buffer.names[slot];
+    trace_dump_buffer.name_task[slot] = task;
+    strncpy(dst, name, TRACE_CONFIG_NAME_LEN - 1);
+    dst[TRACE_CONFIG_NAME_LEN - 1] = '\0';
+    trace_event_(TRACE_EVENT_TASK_CREATE, 0, task);
+}
+
+#else
+
+void trace_init(void)
+{
+}
+
+void trace_start(void)
+{
+}
+
+void trace_stop(void)
+{
+}
+
+void trace_user(uint16_t aux, uint32_t arg)
+{
+}
+
+void trace_dump(void)
+{
+}
+
+#endif
+
+/********************** end of file ******************************************/
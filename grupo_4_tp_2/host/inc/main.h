@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : main.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Reemplazo de Core/Inc/main.h para el build de host (FreeRTOS, port POSIX).
+ * Declara el subconjunto del HAL y de CMSIS que usa app/: los GPIO, el TIM2
+ * del timebase y el DWT se resuelven contra los modelos de host/src/sim.c
+ */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/********************** macros ***********************************************/
+
+#define HAL_MAX_DELAY                           (0xFFFFFFFFU)
+
+#define GPIO_PIN_0                              ((uint16_t)0x0001)
+#define GPIO_PIN_1                              ((uint16_t)0x0002)
+#define GPIO_PIN_2                              ((uint16_t)0x0004)
+#define GPIO_PIN_3                              ((uint16_t)0x0008)
+#define GPIO_PIN_4                              ((uint16_t)0x0010)
+#define GPIO_PIN_5                              ((uint16_t)0x0020)
+#define GPIO_PIN_6                              ((uint16_t)0x0040)
+#define GPIO_PIN_7                              ((uint16_t)0x0080)
+#define GPIO_PIN_8                              ((uint16_t)0x0100)
+#define GPIO_PIN_9                              ((uint16_t)0x0200)
+#define GPIO_PIN_10                             ((uint16_t)0x0400)
+#define GPIO_PIN_11                             ((uint16_t)0x0800)
+#define GPIO_PIN_12                             ((uint16_t)0x1000)
+#define GPIO_PIN_13                             ((uint16_t)0x2000)
+#define GPIO_PIN_14                             ((uint16_t)0x4000)
+#define GPIO_PIN_15                             ((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT                         (0x00000000U)
+#define GPIO_MODE_OUTPUT_PP                     (0x00000001U)
+#define GPIO_MODE_IT_RISING_FALLING             (0x10310000U)
+#define GPIO_NOPULL                             (0x00000000U)
+#define GPIO_SPEED_FREQ_LOW                     (0x00000000U)
+
+/* Puertos simulados */
+#define GPIOA                                   (&sim_gpio[0])
+#define GPIOB                                   (&sim_gpio[1])
+#define GPIOC                                   (&sim_gpio[2])
+#define SIM_GPIO_PORTS                          (3)
+
+/* Pines de la Nucleo-F446RE, como en Core/Inc/main.h */
+#define B1_Pin                                  GPIO_PIN_13
+#define B1_GPIO_Port                            GPIOC
+#define LD2_Pin                                 GPIO_PIN_5
+#define LD2_GPIO_Port                           GPIOA
+
+/* TIM2 del timebase: cada acceso sincroniza CNT con el reloj simulado */
+#define TIM2                                    (sim_tim2())
+
+/* DWT: CYCCNT avanza con el reloj simulado a SystemCoreClock. Las escrituras
+ * a CYCCNT (cycle_counter_reset) no tienen efecto */
+#define DWT                                     (sim_dwt())
+#define CoreDebug                               (&sim_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk              (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk                  (1UL << 0)
+
+/********************** typedef **********************************************/
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U,
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET,
+} GPIO_PinState;
+
+typedef struct
+{
+    char name;                  // 'A', 'B', ...
+    uint16_t odr;               // salidas
+    uint16_t idr;               // entradas
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+typedef struct
+{
+    volatile uint32_t CNT;
+} TIM_TypeDef;
+
+typedef struct
+{
+    TIM_TypeDef* Instance;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+    void* Instance;
+} UART_HandleTypeDef;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/********************** external data declaration ****************************/
+
+extern uint32_t SystemCoreClock;
+extern GPIO_TypeDef sim_gpio[SIM_GPIO_PORTS];
+extern CoreDebug_Type sim_core_debug;
+extern volatile uint32_t sim_primask;
+
+/********************** external functions declaration ***********************/
+
+TIM_TypeDef* sim_tim2(void);
+DWT_Type* sim_dwt(void);
+void sim_primask_set(uint32_t primask);
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+uint32_t HAL_GetTick(void);
+void Error_Handler(void);
+
+/* CMSIS: PRIMASK se emula con las secciones criticas del port */
+static inline uint32_t __CLZ(uint32_t value)
+{
+    return (0 == value) ? 32 : (uint32_t)__builtin_clz(value);
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return sim_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    sim_primask_set(primask);
+}
+
+static inline void __disable_irq(void)
+{
+    sim_primask_set(1);
+}
+
+static inline void __enable_irq(void)
+{
+    sim_primask_set(0);
+}
+
+static inline void __DSB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __ISB(void)
+{
+}
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
+/********************** end of file ******************************************/
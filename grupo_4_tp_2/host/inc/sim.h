@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : sim.h
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+#ifndef HOST_INC_SIM_H_
+#define HOST_INC_SIM_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+
+/********************** macros ***********************************************/
+
+/* Modelos del build de host: reloj (monotonico del sistema, tiempo real),
+ * GPIO con registro de salidas y un guion de flancos del pulsador que se
+ * inyecta como la EXTI de B1 */
+#define SIM_CONFIG_CPU_HZ                       (84000000UL)    // escala del DWT
+#define SIM_CONFIG_SCRIPT_MAX                   (1024)          // flancos por guion
+#define SIM_CONFIG_SETTLE_MS                    (3000)          // despues del ultimo flanco
+#define SIM_CONFIG_TASK_PRIORITY                (configMAX_PRIORITIES - 1)
+#define SIM_CONFIG_TASK_STACK_SIZE              (256)
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+    uint32_t t_us;              // desde el arranque del guion
+    bool pressed;
+} sim_edge_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void sim_init(FILE* led_out);
+uint64_t sim_clock_ns(void);
+uint64_t sim_clock_us(void);
+
+/* Contexto de interrupcion: el cuerpo corre en la tarea del simulador, que
+ * tiene la prioridad mas alta */
+void sim_isr_enter(void);
+void sim_isr_exit(void);
+
+/* Salidas con timestamp: "<us> <fuente> <valores...>" por linea */
+void sim_output(const char* source, uint32_t argc, const uint32_t* argv);
+uint32_t sim_output_count(void);
+
+bool sim_script_load(const char* path);
+uint32_t sim_script_length(void);
+void sim_button_set(bool pressed);
+void sim_script_start(void (*on_done)(void));
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_INC_SIM_H_ */
+/********************** end of file ******************************************/
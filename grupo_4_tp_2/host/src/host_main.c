@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : host_main.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Build de host: task_button, ao_ui, ao_led, ao_timer y el logger sobre el
+ * port POSIX de FreeRTOS, con el pulsador guionado y las salidas del LED
+ * registradas con timestamp.
+ *
+ * Uso:
+ *   make -C host FREERTOS_POSIX_PORT=<FreeRTOS-Kernel>/portable/ThirdParty/GCC/Posix
+ *   host/build/host_sim tools/button_traces/long_then_pulse.txt [salidas.txt]
+ *
+ * Salidas: una linea "<us> <fuente> <valores...>" por flanco del pulsador
+ * ("btn"), escritura de GPIO ("PA5") o cambio de patron del PWM ("pwm",
+ * "blink", "fade"). Sin archivo van a stdout, mezcladas con el logger.
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "profiler.h"
+#include "critical.h"
+#include "latency.h"
+#include "mem_stats.h"
+
+#include "host_app.h"
+#include "sim.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static FILE* out_;
+static mem_stats_snapshot_t mem_snapshot_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/* Fin del guion, desde la tarea del simulador: los reportes salen por el
+ * logger y entre bloque y bloque se espera a que su tarea los entregue (la
+ * cola diferida es chica). logger_flush no consume desde aca, asi que el
+ * exit final no corta ninguna linea */
+static void host_done_(void)
+{
+    LOGGER_INFO("host: %lu flancos, %lu salidas", sim_script_length(), sim_output_count());
+    logger_flush();
+    profiler_report();
+    logger_flush();
+    latency_report();
+    logger_flush();
+    critical_report();
+    logger_flush();
+    (void)mem_stats_snapshot(&mem_snapshot_);
+    mem_stats_report(&mem_snapshot_);
+    logger_flush();
+
+    fflush(stdout);
+    if (NULL != out_)
+    {
+        fflush(out_);
+    }
+    exit(EXIT_SUCCESS);
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+    if ((argc < 2) || (3 < argc))
+    {
+        fprintf(stderr, "uso: %s <guion> [salidas]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    out_ = stdout;
+    if (3 == argc)
+    {
+        out_ = fopen(argv[2], "w");
+        if (NULL == out_)
+        {
+            fprintf(stderr, "%s: no se pudo abrir\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    sim_init(out_);
+    if (!sim_script_load(argv[1]))
+    {
+        fprintf(stderr, "%s: guion invalido o demasiado largo\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    host_app_init();
+    sim_script_start(host_done_);
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : led_pwm_host.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * led_pwm.h sin TIM8 ni DMA: reemplaza a app/src/led_pwm.c y registra cada
+ * cambio de patron en la salida del simulador ("pwm", "blink", "fade"), con
+ * los mismos limites que el driver real
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "sim.h"
+
+#include "led_pwm.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static uint16_t level_;
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+/********************** external functions definition ************************/
+
+void led_pwm_init(void)
+{
+    level_ = 0;
+}
+
+void led_pwm_set(uint16_t level)
+{
+    level_ = (LED_PWM_LEVEL_MAX < level) ? LED_PWM_LEVEL_MAX : level;
+
+    uint32_t value = level_;
+    sim_output("pwm", 1, &value);
+}
+
+bool led_pwm_blink(uint16_t period_ms, uint16_t duty)
+{
+    if ((0 == period_ms) || (LED_PWM_BLINK_PERIOD_MAX_MS < period_ms) || (LED_PWM_LEVEL_MAX < duty))
+    {
+        return false;
+    }
+
+    level_ = 0;
+    uint32_t value[] = {period_ms, duty};
+    sim_output("blink", 2, value);
+    return true;
+}
+
+bool led_pwm_fade(uint16_t level, uint32_t ms)
+{
+    if (LED_PWM_FADE_MAX_MS < ms)
+    {
+        return false;
+    }
+
+    level = (LED_PWM_LEVEL_MAX < level) ? LED_PWM_LEVEL_MAX : level;
+    level_ = level;
+    uint32_t value[] = {level, ms};
+    sim_output("fade", 2, value);
+    return true;
+}
+
+uint16_t led_pwm_level(void)
+{
+    return level_;
+}
+
+/********************** end of file ******************************************/
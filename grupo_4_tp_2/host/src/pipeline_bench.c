@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : pipeline_bench.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Throughput del pipeline boton -> ao_ui -> ao_led en el build de host.
+ *
+ * Una tarea de la prioridad del simulador hace de task_button: inyecta
+ * eventos a ao_ui_send_event a la tasa pedida (PULSE, SHORT, LONG en ronda,
+ * asi cada evento cambia de estado y genera un OFF y un ON a los LED). Por
+ * cada tasa se mide, en la ventana:
+ * - eventos por segundo que despacharon ao_ui y los ao_led
+ * - perdidas: pool del emisor agotado, cola de ao_ui llena, pool de mensajes
+ *   a los LED agotado y cola de ao_led llena
+ * - ciclos por evento de cada dispatch (profiler; ciclos equivalentes a
+ *   SIM_CONFIG_CPU_HZ sobre el reloj del host)
+ * - heap libre y minimo historico, latencia total p99
+ *
+ * Uso:
+ *   make -C host bench FREERTOS_POSIX_PORT=...   (un binario por largo de cola)
+ *   host/build/q5/pipeline_bench [--seconds 2] [--rates 100,1000,10000]
+ *
+ * Cada tasa imprime una linea JSON; tools/pipeline_bench.py corre los
+ * binarios y compara contra una linea de base guardada.
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+#include "profiler.h"
+#include "latency.h"
+#include "memory_pool.h"
+
+#include "ao_ui.h"
+#include "ao_led.h"
+#include "host_app.h"
+#include "sim.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+#define RATES_MAX_               (16)
+#define DRAIN_MS_                (500)      // entre tasas: se vacian las colas
+#define BURST_MAX_               (64)       // eventos por tick como maximo
+
+// Como task_button: un mensaje mas que la cola de ao_ui (solo por puntero)
+#define UI_MESSAGE_POOL_SIZE_    (AO_UI_QUEUE_LENGTH + 1)
+
+/********************** internal data declaration ****************************/
+
+typedef struct
+{
+    uint32_t rate;
+    uint32_t seconds;
+    uint32_t sent;
+    uint32_t pool_exhausted;
+    uint32_t ui_send_failed;
+    uint32_t ui_dispatched;
+    uint32_t led_pool_exhausted;
+    uint32_t led_send_failed;
+    uint32_t led_dispatched;
+    uint32_t ui_cycles_mean;
+    uint32_t ui_cycles_max;
+    uint32_t led_cycles_mean;
+    uint32_t led_cycles_max;
+    uint32_t latency_p99_us;
+    uint32_t heap_free;
+    uint32_t heap_min;
+} bench_result_t;
+
+typedef struct
+{
+    ao_ui_stats_t ui;
+    uint32_t led_dispatched;
+    uint32_t led_send_failed;
+} bench_counters_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static uint32_t rates_[RATES_MAX_] = {100, 1000, 10000};
+static uint32_t rates_count_ = 3;
+static uint32_t seconds_ = 2;
+
+#if (0 == AO_UI_CONFIG_BY_VALUE)
+MEMORY_POOL_STORAGE(ui_message_storage_, ao_ui_message_t, UI_MESSAGE_POOL_SIZE_);
+static memory_pool_t ui_message_pool_;
+#endif
+
+static const ao_ui_action_t actions_[] = {MSG_EVENT_BUTTON_PULSE, MSG_EVENT_BUTTON_SHORT, MSG_EVENT_BUTTON_LONG};
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+static void bench_counters_(bench_counters_t* pcounters)
+{
+    ao_ui_get_stats(&pcounters->ui);
+    pcounters->led_dispatched = 0;
+    pcounters->led_send_failed = 0;
+    for (uint32_t i = 0; i < AO_LED_COLOR__N; i++)
+    {
+        ao_stats_t stats;
+        ao_get_stats(&hao_led[i].ao, &stats);
+        pcounters->led_dispatched += stats.dispatched;
+        pcounters->led_send_failed += stats.send_failed;
+    }
+}
+
+#if (0 == AO_UI_CONFIG_BY_VALUE)
+static void bench_message_free_(void* pmsg)
+{
+    (void)memory_pool_block_put(&ui_message_pool_, pmsg);
+}
+#endif
+
+/* Un evento, como lo envia task_button */
+static void bench_inject_(bench_result_t* presult)
+{
+    ao_ui_action_t action = actions_[presult->sent % (sizeof(actions_) / sizeof(actions_[0]))];
+    presult->sent++;
+
+#if (1 == AO_UI_CONFIG_BY_VALUE)
+    ao_ui_message_t msg = {.callback = NULL, .action = action, .payload = NULL};
+    latency_stamp_clear(&msg.stamp);
+    latency_stamp(&msg.stamp, LATENCY_HOP_EDGE);
+    latency_stamp(&msg.stamp, LATENCY_HOP_DETECT);
+    (void)ao_ui_send_event(&msg);       // los rechazos los cuenta ao_ui (send_failed)
+#else
+    ao_ui_message_t* pmsg = MEMORY_POOL_GET(&ui_message_pool_, ao_ui_message_t);
+    if (NULL == pmsg)
+    {
+        presult->pool_exhausted++;
+        return;
+    }
+    pmsg->action = action;
+    pmsg->callback = bench_message_free_;
+    pmsg->payload = NULL;
+    latency_stamp_clear(&pmsg->stamp);
+    latency_stamp(&pmsg->stamp, LATENCY_HOP_EDGE);
+    latency_stamp(&pmsg->stamp, LATENCY_HOP_DETECT);
+    if (!ao_ui_send_event(pmsg))        // los rechazos los cuenta ao_ui (send_failed)
+    {
+        (void)memory_pool_block_put(&ui_message_pool_, pmsg);
+    }
+#endif
+}
+
+/* Tasa sostenida: en cada tick se envian los eventos que corresponden al
+ * tiempo transcurrido, en rafagas de a lo sumo BURST_MAX_ */
+static void bench_run_(uint32_t rate, bench_result_t* presult)
+{
+    bench_counters_t before, after;
+    profiler_stats_t stats;
+    latency_stats_t latency;
+
+    memset(presult, 0, sizeof(*presult));
+    presult->rate = rate;
+    presult->seconds = seconds_;
+
+    profiler_reset();
+    latency_reset();
+    bench_counters_(&before);
+
+    uint64_t start = sim_clock_us();
+    uint64_t window = (uint64_t)seconds_ * 1000000;
+    uint64_t now;
+    while ((now = sim_clock_us()) < (start + window))
+    {
+        uint64_t due = (((now - start) * rate) / 1000000) + 1;
+        for (uint32_t n = 0; (presult->sent < due) && (n < BURST_MAX_); n++)
+        {
+            bench_inject_(presult);
+        }
+        vTaskDelay(1);
+    }
+
+    bench_counters_(&after);
+    presult->ui_send_failed = after.ui.ao.send_failed - before.ui.ao.send_failed;
+    presult->ui_dispatched = after.ui.ao.dispatched - before.ui.ao.dispatched;
+    presult->led_pool_exhausted = after.ui.led_pool_exhausted - before.ui.led_pool_exhausted;
+    presult->led_send_failed = after.led_send_failed - before.led_send_failed;
+    presult->led_dispatched = after.led_dispatched - before.led_dispatched;
+
+    (void)profiler_get(PROFILER_PROBE_AO_UI, &stats);
+    presult->ui_cycles_mean = (0 == stats.count) ? 0 : (uint32_t)(stats.sum / stats.count);
+    presult->ui_cycles_max = stats.max;
+    (void)profiler_get(PROFILER_PROBE_AO_LED, &stats);
+    presult->led_cycles_mean = (0 == stats.count) ? 0 : (uint32_t)(stats.sum / stats.count);
+    presult->led_cycles_max = stats.max;
+    presult->latency_p99_us = latency_get(LATENCY_STAGE_TOTAL, &latency) ? latency.p99 : 0;
+    presult->heap_free = (uint32_t)xPortGetFreeHeapSize();
+    presult->heap_min = (uint32_t)xPortGetMinimumEverFreeHeapSize();
+}
+
+static void bench_print_(const bench_result_t* presult)
+{
+    printf("{\"ui_queue\": %u, \"led_queue\": %u, \"by_value\": %u, \"rate\": %lu, \"seconds\": %lu, "
+           "\"sent\": %lu, \"events_per_s\": %lu, \"led_events_per_s\": %lu, "
+           "\"pool_exhausted\": %lu, \"ui_send_failed\": %lu, \"led_pool_exhausted\": %lu, \"led_send_failed\": %lu, "
+           "\"ui_cycles_mean\": %lu, \"ui_cycles_max\": %lu, \"led_cycles_mean\": %lu, \"led_cycles_max\": %lu, "
+           "\"latency_p99_us\": %lu, \"heap_free\": %lu, \"heap_min\": %lu}\n",
+           (unsigned)AO_UI_QUEUE_LENGTH, (unsigned)AO_LED_QUEUE_LENGTH, (unsigned)AO_UI_CONFIG_BY_VALUE,
+           (unsigned long)presult->rate, (unsigned long)presult->seconds, (unsigned long)presult->sent,
+           (unsigned long)(presult->ui_dispatched / presult->seconds),
+           (unsigned long)(presult->led_dispatched / presult->seconds),
+           (unsigned long)presult->pool_exhausted, (unsigned long)presult->ui_send_failed,
+           (unsigned long)presult->led_pool_exhausted, (unsigned long)presult->led_send_failed,
+           (unsigned long)presult->ui_cycles_mean, (unsigned long)presult->ui_cycles_max,
+           (unsigned long)presult->led_cycles_mean, (unsigned long)presult->led_cycles_max,
+           (unsigned long)presult->latency_p99_us, (unsigned long)presult->heap_free,
+           (unsigned long)presult->heap_min);
+    fflush(stdout);
+}
+
+static void task_pipeline_bench_(void* argument)
+{
+    bench_result_t result;
+
+#if (0 == AO_UI_CONFIG_BY_VALUE)
+    MEMORY_POOL_INIT(&ui_message_pool_, ui_message_storage_);
+#endif
+
+    for (uint32_t i = 0; i < rates_count_; i++)
+    {
+        bench_run_(rates_[i], &result);
+        vTaskDelay(pdMS_TO_TICKS(DRAIN_MS_));
+        // La tarea del logger entrega lo pendiente antes de la linea JSON
+        logger_flush();
+        bench_print_(&result);
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+static bool bench_parse_rates_(char* list)
+{
+    rates_count_ = 0;
+    for (char* tok = strtok(list, ","); NULL != tok; tok = strtok(NULL, ","))
+    {
+        uint32_t rate = (uint32_t)strtoul(tok, NULL, 10);
+        if ((RATES_MAX_ <= rates_count_) || (0 == rate))
+        {
+            return false;
+        }
+        rates_[rates_count_++] = rate;
+    }
+    return 0 < rates_count_;
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = false;
+        if ((0 == strcmp(argv[i], "--seconds")) && ((i + 1) < argc))
+        {
+            seconds_ = (uint32_t)strtoul(argv[++i], NULL, 10);
+            ok = (0 < seconds_);
+        }
+        else if ((0 == strcmp(argv[i], "--rates")) && ((i + 1) < argc))
+        {
+            ok = bench_parse_rates_(argv[++i]);
+        }
+        if (!ok)
+        {
+            fprintf(stderr, "uso: %s [--seconds s] [--rates r1,r2,...]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    sim_init(NULL);
+    host_app_init();
+
+    BaseType_t status;
+    status = xTaskCreate(task_pipeline_bench_, "task_bench", SIM_CONFIG_TASK_STACK_SIZE, NULL, SIM_CONFIG_TASK_PRIORITY, NULL);
+    while (pdPASS != status)
+    {
+        // error
+    }
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
+
+/********************** end of file ******************************************/
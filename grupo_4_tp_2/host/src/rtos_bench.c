@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : rtos_bench.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Los benchmarks de app/src/bench.c y bench_rtos.c en el build de host, con
+ * la aplicacion inicializada como en el target (el pulsador queda quieto).
+ *
+ * Uso:
+ *   make -C host FREERTOS_POSIX_PORT=...
+ *   host/build/rtos_bench
+ *
+ * Los ciclos son tiempo de pared escalado a SIM_CONFIG_CPU_HZ: sirven para
+ * comparar primitivas entre si, no como valores absolutos del Cortex-M4.
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "logger.h"
+
+#include "bench.h"
+#include "host_app.h"
+#include "sim.h"
+
+/********************** macros and definitions *******************************/
+
+#define LOGGER_MODULE            APP
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data definition *****************************/
+
+/********************** internal functions definition ************************/
+
+static void task_rtos_bench_(void* argument)
+{
+    bench_run();
+    // Vuelve cuando la tarea del logger imprimio todo: exit no corta el vaciado
+    logger_flush();
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+    BaseType_t status;
+
+    sim_init(NULL);
+    host_app_init();
+
+    status = xTaskCreate(task_rtos_bench_, "task_bench", BENCH_CONFIG_TASK_STACK_SIZE, NULL, BENCH_CONFIG_TASK_PRIORITY, NULL);
+    while (pdPASS != status)
+    {
+        // error
+    }
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : sim.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "board.h"
+#include "timebase.h"
+#include "task_button.h"
+
+#include "sim.h"
+
+/********************** macros and definitions *******************************/
+
+#define LINE_MAX_                (256)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static uint64_t start_ns_;
+static FILE* out_;
+static uint32_t out_count_;
+static volatile bool in_isr_;
+
+static TIM_TypeDef tim2_;
+static DWT_Type dwt_;
+
+static sim_edge_t script_[SIM_CONFIG_SCRIPT_MAX];
+static uint32_t script_len_;
+static void (*on_done_)(void);
+
+/********************** external data definition *****************************/
+
+uint32_t SystemCoreClock = SIM_CONFIG_CPU_HZ;
+GPIO_TypeDef sim_gpio[SIM_GPIO_PORTS] = {{.name = 'A'}, {.name = 'B'}, {.name = 'C'}};
+CoreDebug_Type sim_core_debug;
+volatile uint32_t sim_primask;
+
+/********************** internal functions definition ************************/
+
+static uint64_t sim_monotonic_ns_(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t sim_pin_index_(uint16_t pin)
+{
+    return (uint32_t)__builtin_ctz(pin);
+}
+
+/* Mismo formato que tools/button_traces: "<t_ms> <nivel>", '#' comenta */
+static bool sim_script_parse_(FILE* f)
+{
+    char line[LINE_MAX_];
+    script_len_ = 0;
+    while (NULL != fgets(line, sizeof(line), f))
+    {
+        double t_ms;
+        int level;
+        if (('#' == line[0]) || (2 != sscanf(line, "%lf %d", &t_ms, &level)))
+        {
+            continue;
+        }
+        if ((SIM_CONFIG_SCRIPT_MAX <= script_len_) || (t_ms < 0))
+        {
+            return false;
+        }
+        script_[script_len_].t_us = (uint32_t)(t_ms * 1000.0 + 0.5);
+        script_[script_len_].pressed = (0 != level);
+        script_len_++;
+    }
+    return true;
+}
+
+/* Espera con vTaskDelay hasta ~1 tick antes y el resto activa: los rebotes
+ * del guion estan a fracciones de ms. El tick del port puede derivar del
+ * reloj monotonico, por eso se vuelve a medir despues de cada espera */
+static void sim_wait_until_(uint64_t at_us)
+{
+    uint64_t now;
+    while (at_us > ((now = sim_clock_us()) + 2000))
+    {
+        vTaskDelay(pdMS_TO_TICKS((uint32_t)((at_us - now) / 1000) - 1));
+    }
+    while (sim_clock_us() < at_us)
+    {
+    }
+}
+
+static void task_sim_(void* argument)
+{
+    uint64_t start = sim_clock_us();
+    for (uint32_t i = 0; i < script_len_; i++)
+    {
+        sim_wait_until_(start + script_[i].t_us);
+        sim_button_set(script_[i].pressed);
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(SIM_CONFIG_SETTLE_MS));
+    if (NULL != on_done_)
+    {
+        on_done_();
+    }
+    vTaskDelete(NULL);
+}
+
+/********************** external functions definition ************************/
+
+void sim_init(FILE* led_out)
+{
+    start_ns_ = sim_monotonic_ns_();
+    out_ = led_out;
+    out_count_ = 0;
+
+    // Pulsador suelto: B1 tiene pull-up externo y se lee en 1
+    sim_gpio[2].idr |= B1_Pin;
+}
+
+uint64_t sim_clock_ns(void)
+{
+    return sim_monotonic_ns_() - start_ns_;
+}
+
+uint64_t sim_clock_us(void)
+{
+    return sim_clock_ns() / 1000;
+}
+
+TIM_TypeDef* sim_tim2(void)
+{
+    tim2_.CNT = (uint32_t)sim_clock_us();
+    return &tim2_;
+}
+
+DWT_Type* sim_dwt(void)
+{
+    dwt_.CYCCNT = (uint32_t)((sim_clock_ns() * (SystemCoreClock / 1000000)) / 1000);
+    return &dwt_;
+}
+
+/* PRIMASK no anida; la seccion critica del port si, asi que un
+ * __set_PRIMASK(0) dentro de taskENTER_CRITICAL no desenmascara */
+void sim_primask_set(uint32_t primask)
+{
+    if ((0 != primask) && (0 == sim_primask))
+    {
+        portENTER_CRITICAL();
+        sim_primask = 1;
+    }
+    else if ((0 == primask) && (0 != sim_primask))
+    {
+        sim_primask = 0;
+        portEXIT_CRITICAL();
+    }
+}
+
+void sim_isr_enter(void)
+{
+    in_isr_ = true;
+}
+
+void sim_isr_exit(void)
+{
+    in_isr_ = false;
+}
+
+BaseType_t xPortIsInsideInterrupt(void)
+{
+    return in_isr_ ? pdTRUE : pdFALSE;
+}
+
+void sim_output(const char* source, uint32_t argc, const uint32_t* argv)
+{
+    out_count_++;
+    if (NULL == out_)
+    {
+        return;
+    }
+    fprintf(out_, "%llu %s", (unsigned long long)sim_clock_us(), source);
+    for (uint32_t i = 0; i < argc; i++)
+    {
+        fprintf(out_, " %lu", (unsigned long)argv[i]);
+    }
+    fputc('\n', out_);
+}
+
+uint32_t sim_output_count(void)
+{
+    return out_count_;
+}
+
+bool sim_script_load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (NULL == f)
+    {
+        return false;
+    }
+    bool ok = sim_script_parse_(f);
+    fclose(f);
+    return ok;
+}
+
+uint32_t sim_script_length(void)
+{
+    return script_len_;
+}
+
+/* Cambia el nivel de B1 y dispara su EXTI (ambos flancos) */
+void sim_button_set(bool pressed)
+{
+    GPIO_PinState level = pressed ? BTN_PRESSED : BTN_HOVER;
+    if (GPIO_PIN_SET == level)
+    {
+        BTN_PORT->idr |= BTN_PIN;
+    }
+    else
+    {
+        BTN_PORT->idr &= (uint16_t)~BTN_PIN;
+    }
+
+    uint32_t value = pressed ? 1 : 0;
+    sim_output("btn", 1, &value);
+
+    sim_isr_enter();
+    HAL_GPIO_EXTI_Callback(BTN_PIN);
+    sim_isr_exit();
+}
+
+void sim_script_start(void (*on_done)(void))
+{
+    on_done_ = on_done;
+
+    BaseType_t status;
+    status = xTaskCreate(task_sim_, "task_sim", SIM_CONFIG_TASK_STACK_SIZE, NULL, SIM_CONFIG_TASK_PRIORITY, NULL);
+    while (pdPASS != status)
+    {
+        // error
+    }
+}
+
+/* HAL */
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    return (0 != (GPIOx->idr & GPIO_Pin)) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (GPIO_PIN_RESET != PinState)
+    {
+        GPIOx->odr |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->odr &= (uint16_t)~GPIO_Pin;
+    }
+
+    char source[8];
+    uint32_t value = (GPIO_PIN_RESET != PinState) ? 1 : 0;
+    snprintf(source, sizeof(source), "P%c%lu", GPIOx->name, (unsigned long)sim_pin_index_(GPIO_Pin));
+    sim_output(source, 1, &value);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    HAL_GPIO_WritePin(GPIOx, GPIO_Pin, (0 != (GPIOx->odr & GPIO_Pin)) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+/* Como en Core/Src/main.c */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    button_exti_isr(GPIO_Pin);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return timebase_ms();
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler\n");
+    abort();
+}
+
+/* FreeRTOS */
+
+void configureTimerForRunTimeStats(void)
+{
+}
+
+unsigned long getRunTimeCounterValue(void)
+{
+    return timebase_us32();
+}
+
+void vAssertCalled(const char* file, unsigned long line)
+{
+    fprintf(stderr, "assert: %s:%lu\n", file, line);
+    abort();
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : button_replay.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Reproduce en el host trazas de flancos grabadas del pulsador sobre el
+ * mismo motor que usa task_button (app/src/button_engine.c) y compara la
+ * clasificacion con la esperada.
+ *
+ * Uso:
+ *   cc -I app/inc -o button_replay tools/button_replay.c app/src/button_engine.c
+ *   ./button_replay tools/button_traces/short.txt tools/button_traces/glitch.txt ...
+ *
+ * Formato de traza: una linea por flanco "<t_ms> <nivel>" (1 = presionado),
+ * comentarios con '#' y una linea "# expect: PULSE SHORT ..." (o "NONE").
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "button_engine.h"
+
+/********************** macros and definitions *******************************/
+
+#define TICKS_PER_MS_            (1000)     // la traza se reproduce en us
+#define MAX_EVENTS_              (32)
+#define LINE_MAX_                (256)
+
+/********************** internal data definition *****************************/
+
+static const char* const type_name_[] = {"NONE", "PULSE", "SHORT", "LONG"};
+
+/********************** internal functions definition ************************/
+
+static void collect_(button_type_t type, button_type_t* got, int* ngot)
+{
+	if ((BUTTON_TYPE_NONE != type) && (*ngot < MAX_EVENTS_))
+	{
+		got[(*ngot)++] = type;
+	}
+}
+
+/* Emula a task_button: despierta con cada flanco y, con un cambio pendiente,
+ * al vencer el antirrebote */
+static void poll_until_(button_engine_t* engine, uint32_t now, button_type_t* got, int* ngot)
+{
+	if (button_engine_pending(engine))
+	{
+		uint32_t settle = engine->raw_time + engine->debounce_ticks;
+		if ((int32_t)(now - settle) >= 0)
+		{
+			collect_(button_engine_poll(engine, settle), got, ngot);
+		}
+	}
+}
+
+static int parse_type_(const char* name)
+{
+	for (int i = 0; i < BUTTON_TYPE__N; i++)
+	{
+		if (0 == strcmp(name, type_name_[i]))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static bool replay_(const char* path)
+{
+	FILE* f = fopen(path, "r");
+	if (NULL == f)
+	{
+		printf("%s: no se pudo abrir\n", path);
+		return false;
+	}
+
+	button_engine_t engine;
+	button_engine_init(&engine, TICKS_PER_MS_, BUTTON_ENGINE_DEBOUNCE_MS, false);
+
+	button_type_t expect[MAX_EVENTS_];
+	button_type_t got[MAX_EVENTS_];
+	int nexpect = 0;
+	int ngot = 0;
+	uint32_t now = 0;
+	char line[LINE_MAX_];
+
+	while (NULL != fgets(line, sizeof(line), f))
+	{
+		if (0 == strncmp(line, "# expect:", 9))
+		{
+			for (char* tok = strtok(line + 9, " \t\r\n"); NULL != tok; tok = strtok(NULL, " \t\r\n"))
+			{
+				int type = parse_type_(tok);
+				if ((0 < type) && (nexpect < MAX_EVENTS_))
+				{
+					expect[nexpect++] = (button_type_t)type;
+				}
+			}
+			continue;
+		}
+
+		double t_ms;
+		int level;
+		if (('#' == line[0]) || (2 != sscanf(line, "%lf %d", &t_ms, &level)))
+		{
+			continue;
+		}
+
+		now = (uint32_t)(t_ms * TICKS_PER_MS_);
+		poll_until_(&engine, now, got, &ngot);
+		button_engine_edge(&engine, now, (0 != level));
+		collect_(button_engine_poll(&engine, now), got, &ngot);
+	}
+	fclose(f);
+
+	poll_until_(&engine, now + engine.debounce_ticks, got, &ngot);
+
+	bool ok = (nexpect == ngot);
+	for (int i = 0; ok && (i < ngot); i++)
+	{
+		ok = (expect[i] == got[i]);
+	}
+
+	printf("%s %s: flancos=%u rebotes=%u ->", ok ? "OK  " : "FAIL", path, engine.edges, engine.bounces);
+	for (int i = 0; i < ngot; i++)
+	{
+		printf(" %s", type_name_[got[i]]);
+	}
+	printf("\n");
+	return ok;
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+	int failed = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!replay_(argv[i]))
+		{
+			failed++;
+		}
+	}
+	return (0 == failed) ? 0 : 1;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,1111 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : heap_bench.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Banco de asignadores en el host: la misma secuencia de malloc/free contra
+ * - heap_4: modelo de portable/MemMang/heap_4.c (first fit sobre la lista
+ *   libre ordenada por direccion, cabecera de 8 bytes, union de vecinos)
+ * - heap_5: el mismo algoritmo sobre varias regiones no contiguas
+ * - tlsf: app/src/tlsf.c
+ * - pools: bloques fijos por clase de tamano (16 .. 2048), dimensionados con
+ *   el pico de cada clase en una corrida previa y recortados al heap
+ *
+ * Cargas:
+ *   --trace archivo    reproduce una traza capturada en el firmware
+ *                      (trace_view.py --heap-trace, ver abajo)
+ *   --model firmware   objetos activos que se crean con el primer evento y se
+ *                      eliminan tras AO_*_IDLE_TIMEOUT_MS (cola, stack y TCB)
+ *   --model random     tamanos y vidas al azar (peor caso de fragmentacion)
+ *   --hours h          corrida larga: con --trace se sortean vidas y tamanos
+ *                      de la traza (las asignaciones que nunca se liberan se
+ *                      hacen una vez al arranque)
+ *
+ * Uso:
+ *   cc -O2 -I app/inc -o heap_bench tools/heap_bench.c app/src/tlsf.c -lm
+ *   ./heap_bench --model firmware --hours 720
+ *   ./heap_bench --trace heap.txt [--hours 168] [--csv largest.csv]
+ *
+ * Traza: una linea por operacion, "<us> m <id> <bytes>" o "<us> f <id>". El
+ * id es la direccion original; bytes es el pedido (el tamano que registra
+ * traceMALLOC menos la cabecera de heap_4).
+ *
+ * Informa por asignador: operaciones, fallos y el primero (en horas de
+ * uptime simulado), peor malloc en pasos (nodos de lista recorridos), p99 y
+ * media en ns, libre minimo y el menor "mayor bloque libre" visto. --csv guarda el mayor
+ * bloque libre en el tiempo. En el host los punteros de TLSF son de 64 bits:
+ * sus cabeceras ocupan 16 bytes en vez de 8 y el resultado lo perjudica.
+ * El peor caso es el de pasos: el maximo en ns del host mide al scheduler del
+ * SO (interrupciones, migraciones), por eso se informa el p99.
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "tlsf.h"
+
+/********************** macros and definitions *******************************/
+
+#define HEAP_SIZE_               (15360)    // configTOTAL_HEAP_SIZE
+#define HEAP4_HEADER_            (8)        // xHeapStructSize en el M4
+#define HEAP4_ALIGN_             (8)        // portBYTE_ALIGNMENT
+#define HEAP4_MIN_BLOCK_         (2 * HEAP4_HEADER_)
+#define HEAP4_NIL_               (UINT32_MAX)
+#define HEAP5_REGIONS_MAX_       (4)
+#define HEAP5_GAP_               (64)       // separa regiones: no se unen
+
+#define POOL_CLASSES_            (8)
+#define POOL_CLASS_MIN_          (16U)
+
+#define TRACE_MAX_               (1 << 20)
+#define LIVE_MAX_                (4096)
+#define SAMPLE_MS_               (60000)    // muestreo del mayor bloque libre
+#define NS_BUCKET_               (10)       // histograma de tiempos de malloc
+#define NS_BUCKETS_              (1000)     // hasta 10 us; el ultimo acumula el resto
+
+// Modelo del firmware (estimaciones para el M4; una traza da los reales)
+#define FW_TCB_                  (184)      // TCB con configUSE_NEWLIB_REENTRANT
+#define FW_QUEUE_                (80)       // Queue_t
+#define FW_ITEM_                 (4)        // eventos por puntero
+#define FW_IDLE_MS_              (10000)    // AO_*_IDLE_TIMEOUT_MS
+#define FW_IDLE_TASK_MS_         (5)        // el idle libera TCB y stack despues
+#define FW_PRESS_MEAN_MS_        (4000)
+
+#define RANDOM_SIZE_MAX_         (1024)
+#define RANDOM_LIFE_MAX_MS_      (10000)
+#define RANDOM_GAP_MEAN_MS_      (200)
+
+/********************** internal data declaration ****************************/
+
+typedef struct
+{
+	uint32_t next;                  // desplazamiento del siguiente libre
+	uint32_t size;                  // bit 31: asignado (xBlockAllocatedBit)
+} heap4_link_t;
+
+/* heap_4/heap_5 sobre desplazamientos de 32 bits: las cabeceras ocupan lo
+ * mismo que en el target aunque el host sea de 64 bits */
+typedef struct
+{
+	uint8_t* mem;
+	uint32_t start;                 // xStart (fuera de las regiones)
+	uint32_t end;                   // pxEnd de la ultima region
+	uint32_t free;
+	uint32_t free_min;
+	uint64_t steps;
+} heap4_t;
+
+typedef struct
+{
+	uint32_t block;
+	uint32_t count;
+	uint32_t used;
+	uint32_t* stack;                // indices libres
+	uint8_t* mem;
+} pool_class_t;
+
+typedef struct
+{
+	const char* name;
+	bool (*init)(void);
+	void* (*alloc)(size_t size);
+	void (*release)(void* ptr);
+	void (*stats)(uint32_t* pfree, uint32_t* plargest);
+	uint64_t (*steps)(void);        // pasos acumulados (NULL: O(1))
+} allocator_t;
+
+typedef enum
+{
+	OP_MALLOC_,
+	OP_FREE_,
+} op_kind_t;
+
+typedef struct
+{
+	uint64_t us;
+	uint8_t kind;
+	uint32_t size;
+	uint64_t id;
+} trace_op_t;
+
+/* Bloque con vida conocida (modelos random y traza, partes de una tarea
+ * eliminada que esperan a la tarea idle) */
+typedef struct
+{
+	void* ptr;
+	uint64_t release_ms;
+} live_t;
+
+/* Objeto activo del modelo del firmware */
+typedef struct
+{
+	uint32_t queue_length;
+	uint32_t stack_words;
+	bool running;
+	uint64_t stop_ms;               // ultimo evento + FW_IDLE_MS_
+	void* queue;
+	void* stack;
+	void* tcb;
+} fw_ao_t;
+
+typedef struct
+{
+	uint64_t ops;
+	uint64_t failures;
+	double first_failure_h;
+	uint64_t steps_max;
+	uint64_t ns_hist[NS_BUCKETS_];
+	double ns_sum;
+	uint64_t mallocs;
+	uint32_t free_min;
+	uint32_t largest_min;
+	uint32_t largest_end;
+} result_t;
+
+typedef enum
+{
+	MODEL_TRACE_,
+	MODEL_FIRMWARE_,
+	MODEL_RANDOM_,
+} model_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+static uint32_t rng_;
+
+static uint8_t arena_[HEAP_SIZE_ + (HEAP5_REGIONS_MAX_ + 1) * HEAP5_GAP_];
+static heap4_t heap4_;
+static uint32_t heap5_regions_[HEAP5_REGIONS_MAX_] = {10240, 5120};
+static uint32_t heap5_count_ = 2;
+
+static tlsf_t tlsf_;
+
+static pool_class_t pools_[POOL_CLASSES_];
+static uint32_t pool_peak_[POOL_CLASSES_];
+static uint32_t pool_live_[POOL_CLASSES_];
+static uint32_t pool_stack_[HEAP_SIZE_ / POOL_CLASS_MIN_];
+static bool pool_sizing_;
+
+static trace_op_t* trace_;
+static uint32_t trace_count_;
+
+static live_t live_[LIVE_MAX_];
+static uint32_t live_count_;
+
+static FILE* csv_;
+
+/********************** internal functions definition ************************/
+
+static uint32_t rand_(void)
+{
+	rng_ ^= rng_ << 13;
+	rng_ ^= rng_ >> 17;
+	rng_ ^= rng_ << 5;
+	return rng_;
+}
+
+/* Exponencial de media mean (llegadas de Poisson) */
+static uint64_t rand_exp_(uint32_t mean)
+{
+	double u = ((double)(rand_() & 0xFFFFFF) + 1.0) / 16777217.0;
+	double x = -(double)mean * log(u);
+	return (uint64_t)x + 1;
+}
+
+static double now_ns_(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ---- Modelo de heap_4.c / heap_5.c ---- */
+
+static heap4_link_t* link_(uint32_t offset)
+{
+	return (heap4_link_t*)(heap4_.mem + offset);
+}
+
+/* prvInsertBlockIntoFreeList: busca por direccion y une con los vecinos */
+static void heap4_insert_(uint32_t block)
+{
+	uint32_t it = heap4_.start;
+
+	while (link_(it)->next < block)
+	{
+		it = link_(it)->next;
+		heap4_.steps++;
+	}
+
+	if ((it != heap4_.start) && ((it + link_(it)->size) == block))
+	{
+		link_(it)->size += link_(block)->size;
+		block = it;
+	}
+
+	uint32_t next = link_(it)->next;
+	if ((next != heap4_.end) && ((block + link_(block)->size) == next))
+	{
+		link_(block)->size += link_(next)->size;
+		link_(block)->next = link_(next)->next;
+	}
+	else
+	{
+		link_(block)->next = next;
+	}
+
+	if (it != block)
+	{
+		link_(it)->next = block;
+	}
+}
+
+/* vPortDefineHeapRegions: cada region termina en un marcador de tamano 0 que
+ * queda en la lista y apunta a la region siguiente. heap_4 es una region */
+static bool heap4_define_(const uint32_t* sizes, uint32_t count)
+{
+	uint32_t offset = HEAP5_GAP_;
+	uint32_t prev_end = HEAP4_NIL_;
+
+	memset(arena_, 0, sizeof(arena_));
+	heap4_.mem = arena_;
+	heap4_.start = 0;                           // xStart en el hueco inicial
+	link_(0)->size = 0;
+	heap4_.free = 0;
+	heap4_.steps = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t first = offset;
+		uint32_t end = (first + sizes[i] - HEAP4_HEADER_) & ~(uint32_t)(HEAP4_ALIGN_ - 1);
+		link_(first)->size = end - first;
+		link_(first)->next = end;
+		link_(end)->size = 0;
+		link_(end)->next = HEAP4_NIL_;
+		if (HEAP4_NIL_ == prev_end)
+		{
+			link_(heap4_.start)->next = first;
+		}
+		else
+		{
+			link_(prev_end)->next = first;
+		}
+		prev_end = end;
+		heap4_.free += end - first;
+		offset = end + HEAP4_HEADER_ + HEAP5_GAP_;
+		if (offset > sizeof(arena_))
+		{
+			return false;
+		}
+	}
+	heap4_.end = prev_end;
+	heap4_.free_min = heap4_.free;
+	return true;
+}
+
+static bool heap4_init_(void)
+{
+	static const uint32_t size = HEAP_SIZE_;
+	return heap4_define_(&size, 1);
+}
+
+static bool heap5_init_(void)
+{
+	return heap4_define_(heap5_regions_, heap5_count_);
+}
+
+static void* heap4_alloc_(size_t size)
+{
+	uint32_t wanted = (uint32_t)size + HEAP4_HEADER_;
+	wanted = (wanted + HEAP4_ALIGN_ - 1) & ~(uint32_t)(HEAP4_ALIGN_ - 1);
+	if ((0 == size) || (wanted > heap4_.free))
+	{
+		return NULL;
+	}
+
+	uint32_t prev = heap4_.start;
+	uint32_t block = link_(prev)->next;
+	while ((link_(block)->size < wanted) && (HEAP4_NIL_ != link_(block)->next))
+	{
+		prev = block;
+		block = link_(block)->next;
+		heap4_.steps++;
+	}
+	if (block == heap4_.end)
+	{
+		return NULL;
+	}
+
+	link_(prev)->next = link_(block)->next;
+	if ((link_(block)->size - wanted) > HEAP4_MIN_BLOCK_)
+	{
+		uint32_t split = block + wanted;
+		link_(split)->size = link_(block)->size - wanted;
+		link_(block)->size = wanted;
+		heap4_insert_(split);
+	}
+	heap4_.free -= link_(block)->size;
+	if (heap4_.free < heap4_.free_min)
+	{
+		heap4_.free_min = heap4_.free;
+	}
+	link_(block)->size |= 0x80000000UL;
+	link_(block)->next = HEAP4_NIL_;
+	return heap4_.mem + block + HEAP4_HEADER_;
+}
+
+static void heap4_release_(void* ptr)
+{
+	uint32_t block = (uint32_t)((uint8_t*)ptr - heap4_.mem) - HEAP4_HEADER_;
+	link_(block)->size &= ~0x80000000UL;
+	heap4_.free += link_(block)->size;
+	heap4_insert_(block);
+}
+
+static void heap4_stats_(uint32_t* pfree, uint32_t* plargest)
+{
+	*pfree = heap4_.free;
+	*plargest = 0;
+	for (uint32_t it = link_(heap4_.start)->next; HEAP4_NIL_ != it; it = link_(it)->next)
+	{
+		// El pedido mas grande que entra: el bloque menos la cabecera
+		if (link_(it)->size > (*plargest + HEAP4_HEADER_))
+		{
+			*plargest = link_(it)->size - HEAP4_HEADER_;
+		}
+	}
+}
+
+static uint64_t heap4_steps_(void)
+{
+	return heap4_.steps;
+}
+
+/* ---- TLSF ---- */
+
+static bool tlsf_init_(void)
+{
+	return tlsf_init(&tlsf_, arena_, HEAP_SIZE_);
+}
+
+static void* tlsf_alloc_(size_t size)
+{
+	return tlsf_malloc(&tlsf_, size);
+}
+
+static void tlsf_release_(void* ptr)
+{
+	tlsf_free(&tlsf_, ptr);
+}
+
+static void tlsf_stats_(uint32_t* pfree, uint32_t* plargest)
+{
+	tlsf_stats_t stats;
+	tlsf_get_stats(&tlsf_, &stats);
+	*pfree = (uint32_t)stats.free;
+	*plargest = (uint32_t)stats.largest_alloc;
+}
+
+/* ---- Pools ---- */
+
+static uint32_t pool_class_(size_t size)
+{
+	uint32_t cls = 0;
+	while ((cls < POOL_CLASSES_) && (size > (POOL_CLASS_MIN_ << cls)))
+	{
+		cls++;
+	}
+	return cls;
+}
+
+/* Con pool_sizing_ solo se cuenta el pico por clase (la memoria es de libc) */
+static bool pool_init_(void)
+{
+	uint64_t wanted = 0;
+	for (uint32_t cls = 0; cls < POOL_CLASSES_; cls++)
+	{
+		wanted += (uint64_t)pool_peak_[cls] * (POOL_CLASS_MIN_ << cls);
+	}
+
+	uint8_t* mem = arena_;
+	uint32_t* stack = pool_stack_;
+	for (uint32_t cls = 0; cls < POOL_CLASSES_; cls++)
+	{
+		pool_class_t* pool = &pools_[cls];
+		pool->block = POOL_CLASS_MIN_ << cls;
+		pool->count = pool_peak_[cls];
+		if (wanted > HEAP_SIZE_)
+		{
+			pool->count = (uint32_t)(((uint64_t)pool->count * HEAP_SIZE_) / wanted);
+		}
+		pool->used = 0;
+		pool->mem = mem;
+		pool->stack = stack;
+		for (uint32_t i = 0; i < pool->count; i++)
+		{
+			pool->stack[i] = pool->count - 1 - i;
+		}
+		mem += (size_t)pool->count * pool->block;
+		stack += pool->count;
+	}
+	return true;
+}
+
+static void* pool_alloc_(size_t size)
+{
+	uint32_t cls = pool_class_(size);
+	if ((0 == size) || (POOL_CLASSES_ <= cls))
+	{
+		return NULL;
+	}
+	if (pool_sizing_)
+	{
+		pool_live_[cls]++;
+		if (pool_live_[cls] > pool_peak_[cls])
+		{
+			pool_peak_[cls] = pool_live_[cls];
+		}
+		uint32_t* ptr = malloc(sizeof(uint32_t));
+		*ptr = cls;
+		return ptr;
+	}
+
+	pool_class_t* pool = &pools_[cls];
+	if (pool->used == pool->count)
+	{
+		return NULL;
+	}
+	uint32_t index = pool->stack[pool->count - 1 - pool->used];
+	pool->used++;
+	return pool->mem + (size_t)index * pool->block;
+}
+
+static void pool_release_(void* ptr)
+{
+	if (pool_sizing_)
+	{
+		pool_live_[*(uint32_t*)ptr]--;
+		free(ptr);
+		return;
+	}
+	for (uint32_t cls = 0; cls < POOL_CLASSES_; cls++)
+	{
+		pool_class_t* pool = &pools_[cls];
+		if (((uint8_t*)ptr >= pool->mem) && ((uint8_t*)ptr < (pool->mem + (size_t)pool->count * pool->block)))
+		{
+			pool->used--;
+			pool->stack[pool->count - 1 - pool->used] = (uint32_t)(((uint8_t*)ptr - pool->mem) / pool->block);
+			return;
+		}
+	}
+}
+
+/* Libre: bloques sin usar de todas las clases. Mayor: la clase mas grande
+ * con algun bloque libre */
+static void pool_stats_(uint32_t* pfree, uint32_t* plargest)
+{
+	*pfree = 0;
+	*plargest = 0;
+	for (uint32_t cls = 0; cls < POOL_CLASSES_; cls++)
+	{
+		if (pools_[cls].used < pools_[cls].count)
+		{
+			*pfree += (pools_[cls].count - pools_[cls].used) * pools_[cls].block;
+			*plargest = pools_[cls].block;
+		}
+	}
+}
+
+static const allocator_t allocators_[] = {
+	{"heap_4", heap4_init_, heap4_alloc_, heap4_release_, heap4_stats_, heap4_steps_},
+	{"heap_5", heap5_init_, heap4_alloc_, heap4_release_, heap4_stats_, heap4_steps_},
+	{"tlsf", tlsf_init_, tlsf_alloc_, tlsf_release_, tlsf_stats_, NULL},
+	{"pools", pool_init_, pool_alloc_, pool_release_, pool_stats_, NULL},
+};
+
+/* ---- Corrida ---- */
+
+static void* run_alloc_(const allocator_t* palloc, size_t size, uint64_t now_ms, result_t* presult)
+{
+	uint64_t steps = (NULL != palloc->steps) ? palloc->steps() : 0;
+	double t0 = now_ns_();
+	void* ptr = palloc->alloc(size);
+	double elapsed = now_ns_() - t0;
+
+	if (NULL != palloc->steps)
+	{
+		steps = palloc->steps() - steps;
+		presult->steps_max = (steps > presult->steps_max) ? steps : presult->steps_max;
+	}
+	uint64_t bucket = (uint64_t)(elapsed / NS_BUCKET_);
+	presult->ns_hist[(bucket < NS_BUCKETS_) ? bucket : (NS_BUCKETS_ - 1)]++;
+	presult->ns_sum += elapsed;
+	presult->mallocs++;
+	presult->ops++;
+	if (NULL == ptr)
+	{
+		if (0 == presult->failures)
+		{
+			presult->first_failure_h = (double)now_ms / 3600000.0;
+		}
+		presult->failures++;
+	}
+	return ptr;
+}
+
+static void run_release_(const allocator_t* palloc, void* ptr, result_t* presult)
+{
+	if (NULL != ptr)
+	{
+		palloc->release(ptr);
+		presult->ops++;
+	}
+}
+
+static void run_sample_(const allocator_t* palloc, uint64_t now_ms, result_t* presult)
+{
+	uint32_t free, largest;
+	palloc->stats(&free, &largest);
+	presult->free_min = (free < presult->free_min) ? free : presult->free_min;
+	presult->largest_min = (largest < presult->largest_min) ? largest : presult->largest_min;
+	presult->largest_end = largest;
+	if ((NULL != csv_) && !pool_sizing_)
+	{
+		fprintf(csv_, "%.3f,%s,%u,%u\n", (double)now_ms / 3600000.0, palloc->name, free, largest);
+	}
+}
+
+static bool live_add_(void* ptr, uint64_t release_ms)
+{
+	if ((NULL == ptr) || (LIVE_MAX_ <= live_count_))
+	{
+		return false;
+	}
+	live_[live_count_].ptr = ptr;
+	live_[live_count_].release_ms = release_ms;
+	live_count_++;
+	return true;
+}
+
+/* Proximo vencimiento entre los bloques con vida (UINT64_MAX: ninguno) */
+static uint64_t live_next_(uint32_t* pindex)
+{
+	uint64_t next = UINT64_MAX;
+	for (uint32_t i = 0; i < live_count_; i++)
+	{
+		if (live_[i].release_ms < next)
+		{
+			next = live_[i].release_ms;
+			*pindex = i;
+		}
+	}
+	return next;
+}
+
+static void live_release_(const allocator_t* palloc, uint32_t index, result_t* presult)
+{
+	run_release_(palloc, live_[index].ptr, presult);
+	live_[index] = live_[--live_count_];
+}
+
+/* Avanza hasta now_ms liberando en orden de vencimiento y muestreando */
+static void run_until_(const allocator_t* palloc, uint64_t now_ms, uint64_t* pnext_sample, result_t* presult)
+{
+	uint32_t index = 0;
+	uint64_t next;
+
+	while ((next = live_next_(&index)) <= now_ms)
+	{
+		while (*pnext_sample <= next)
+		{
+			run_sample_(palloc, *pnext_sample, presult);
+			*pnext_sample += SAMPLE_MS_;
+		}
+		live_release_(palloc, index, presult);
+	}
+	while (*pnext_sample <= now_ms)
+	{
+		run_sample_(palloc, *pnext_sample, presult);
+		*pnext_sample += SAMPLE_MS_;
+	}
+}
+
+/* ---- Modelo del firmware ---- */
+
+/* ao_stop_ libera la cola; la tarea se elimina a si misma y el idle libera
+ * stack y TCB un poco despues */
+static void fw_stop_(const allocator_t* palloc, fw_ao_t* pao, result_t* presult)
+{
+	run_release_(palloc, pao->queue, presult);
+	(void)live_add_(pao->stack, pao->stop_ms + FW_IDLE_TASK_MS_);
+	(void)live_add_(pao->tcb, pao->stop_ms + FW_IDLE_TASK_MS_);
+	pao->running = false;
+}
+
+/* ao_start_: cola, stack y TCB (xTaskCreate con el stack hacia abajo pide el
+ * stack primero). Si algo falla se libera lo anterior y el evento se pierde */
+static void fw_start_(const allocator_t* palloc, fw_ao_t* pao, uint64_t now_ms, result_t* presult)
+{
+	pao->queue = run_alloc_(palloc, FW_QUEUE_ + pao->queue_length * FW_ITEM_, now_ms, presult);
+	pao->stack = (NULL != pao->queue) ? run_alloc_(palloc, pao->stack_words * 4, now_ms, presult) : NULL;
+	pao->tcb = (NULL != pao->stack) ? run_alloc_(palloc, FW_TCB_, now_ms, presult) : NULL;
+	if (NULL == pao->tcb)
+	{
+		run_release_(palloc, pao->stack, presult);
+		run_release_(palloc, pao->queue, presult);
+		return;
+	}
+	pao->running = true;
+}
+
+/* ao_ui y los tres ao_led. Cada pulsacion llega a ao_ui y a un LED al azar;
+ * el objeto detenido arranca y queda vivo hasta FW_IDLE_MS_ sin eventos */
+static void run_firmware_(const allocator_t* palloc, uint64_t horizon_ms, result_t* presult)
+{
+	static const uint32_t permanent[] = {
+		FW_TCB_, 128 * 4,                   // task_button
+		FW_TCB_, 256 * 4,                   // task_logger
+		FW_TCB_, 192 * 4,                   // task_mem_stats
+		FW_TCB_, 256 * 4,                   // ao_timer
+		FW_QUEUE_ + 16 * 8,                 // cola del logger
+		FW_QUEUE_ + 10 * 8,                 // cola de ao_timer
+	};
+	fw_ao_t aos[] = {
+		{.queue_length = 5, .stack_words = 128},
+		{.queue_length = 10, .stack_words = 128},
+		{.queue_length = 10, .stack_words = 128},
+		{.queue_length = 10, .stack_words = 128},
+	};
+	uint64_t next_sample = 0;
+	uint64_t now = 0;
+
+	for (uint32_t i = 0; i < (sizeof(permanent) / sizeof(permanent[0])); i++)
+	{
+		(void)run_alloc_(palloc, permanent[i], 0, presult);
+	}
+
+	while (now < horizon_ms)
+	{
+		uint64_t press = now + rand_exp_(FW_PRESS_MEAN_MS_);
+		uint32_t targets[2] = {0, 1 + (rand_() % 3)};
+
+		// Paradas anteriores a la pulsacion, en orden
+		for (;;)
+		{
+			fw_ao_t* pfirst = NULL;
+			for (uint32_t ao = 0; ao < (sizeof(aos) / sizeof(aos[0])); ao++)
+			{
+				if (aos[ao].running && (aos[ao].stop_ms <= press) && ((NULL == pfirst) || (aos[ao].stop_ms < pfirst->stop_ms)))
+				{
+					pfirst = &aos[ao];
+				}
+			}
+			if (NULL == pfirst)
+			{
+				break;
+			}
+			run_until_(palloc, pfirst->stop_ms, &next_sample, presult);
+			fw_stop_(palloc, pfirst, presult);
+		}
+		now = press;
+		run_until_(palloc, now, &next_sample, presult);
+
+		for (uint32_t t = 0; t < 2; t++)
+		{
+			fw_ao_t* pao = &aos[targets[t]];
+			if (!pao->running)
+			{
+				fw_start_(palloc, pao, now, presult);
+			}
+			pao->stop_ms = now + FW_IDLE_MS_;
+		}
+	}
+	run_sample_(palloc, now, presult);
+}
+
+/* ---- Modelo al azar ---- */
+
+/* Mas pedidos chicos que grandes, vidas de hasta 10 s: en promedio ~45% del
+ * heap ocupado, los fallos vienen de la fragmentacion */
+static void run_random_(const allocator_t* palloc, uint64_t horizon_ms, result_t* presult)
+{
+	uint64_t next_sample = 0;
+	uint64_t now = 0;
+
+	while (now < horizon_ms)
+	{
+		now += rand_exp_(RANDOM_GAP_MEAN_MS_);
+		uint32_t a = rand_() % RANDOM_SIZE_MAX_;
+		uint32_t b = rand_() % RANDOM_SIZE_MAX_;
+		uint32_t size = 8 + ((a * b) / RANDOM_SIZE_MAX_);
+		uint64_t life = 1 + (rand_() % RANDOM_LIFE_MAX_MS_);
+
+		run_until_(palloc, now, &next_sample, presult);
+		(void)live_add_(run_alloc_(palloc, size, now, presult), now + life);
+	}
+	run_sample_(palloc, now, presult);
+}
+
+/* ---- Traza ---- */
+
+static bool trace_load_(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	char line[128];
+
+	if (NULL == file)
+	{
+		return false;
+	}
+	trace_ = malloc(sizeof(trace_op_t) * TRACE_MAX_);
+	trace_count_ = 0;
+	while ((NULL != fgets(line, sizeof(line), file)) && (trace_count_ < TRACE_MAX_))
+	{
+		unsigned long long us, id;
+		unsigned size = 0;
+		char kind;
+		if (('#' == line[0]) || (3 > sscanf(line, "%llu %c %llx %u", &us, &kind, &id, &size)))
+		{
+			continue;
+		}
+		trace_op_t* op = &trace_[trace_count_++];
+		op->us = us;
+		op->kind = ('m' == kind) ? OP_MALLOC_ : OP_FREE_;
+		op->size = size;
+		op->id = id;
+	}
+	fclose(file);
+	return 0 < trace_count_;
+}
+
+/* Indice del malloc que produjo el bloque liberado en la operacion i (las
+ * direcciones se reusan: se busca el ultimo malloc con ese id) */
+static int64_t trace_match_(uint32_t i)
+{
+	for (int64_t j = (int64_t)i - 1; j >= 0; j--)
+	{
+		if (trace_[j].id == trace_[i].id)
+		{
+			return (OP_MALLOC_ == trace_[j].kind) ? j : -1;
+		}
+	}
+	return -1;
+}
+
+/* Una pasada con el orden y los tiempos originales */
+static void run_trace_replay_(const allocator_t* palloc, result_t* presult)
+{
+	void** ptrs = calloc(trace_count_, sizeof(void*));
+	uint64_t next_sample = 0;
+	uint64_t now = 0;
+
+	for (uint32_t i = 0; i < trace_count_; i++)
+	{
+		now = (trace_[i].us - trace_[0].us) / 1000;
+		while (next_sample <= now)
+		{
+			run_sample_(palloc, next_sample, presult);
+			next_sample += SAMPLE_MS_;
+		}
+		if (OP_MALLOC_ == trace_[i].kind)
+		{
+			ptrs[i] = run_alloc_(palloc, trace_[i].size, now, presult);
+		}
+		else
+		{
+			int64_t j = trace_match_(i);
+			if (0 <= j)
+			{
+				run_release_(palloc, ptrs[j], presult);
+				ptrs[j] = NULL;
+			}
+		}
+	}
+	run_sample_(palloc, now, presult);
+	free(ptrs);
+}
+
+/* Corrida larga: lo que la traza nunca libera se asigna al arranque; el
+ * resto llega como Poisson con la tasa de la traza y toma tamano y vida de
+ * un par (malloc, free) de la traza elegido al azar */
+static void run_trace_long_(const allocator_t* palloc, uint64_t horizon_ms, result_t* presult)
+{
+	uint32_t* sizes = malloc(sizeof(uint32_t) * trace_count_);
+	uint64_t* lives = malloc(sizeof(uint64_t) * trace_count_);
+	bool* freed = calloc(trace_count_, sizeof(bool));
+	uint32_t pairs = 0;
+	uint64_t next_sample = 0;
+	uint64_t now = 0;
+
+	for (uint32_t i = 0; i < trace_count_; i++)
+	{
+		int64_t j = (OP_FREE_ == trace_[i].kind) ? trace_match_(i) : -1;
+		if (0 <= j)
+		{
+			freed[j] = true;
+			sizes[pairs] = trace_[j].size;
+			lives[pairs] = (trace_[i].us - trace_[j].us) / 1000;
+			pairs++;
+		}
+	}
+	for (uint32_t i = 0; i < trace_count_; i++)
+	{
+		if ((OP_MALLOC_ == trace_[i].kind) && !freed[i])
+		{
+			(void)run_alloc_(palloc, trace_[i].size, 0, presult);
+		}
+	}
+
+	uint64_t span_ms = (trace_[trace_count_ - 1].us - trace_[0].us) / 1000;
+	uint32_t gap_ms = (0 == pairs) ? 0 : (uint32_t)((span_ms / pairs) + 1);
+	while ((0 != pairs) && (now < horizon_ms))
+	{
+		uint32_t k = rand_() % pairs;
+		now += rand_exp_(gap_ms);
+		run_until_(palloc, now, &next_sample, presult);
+		(void)live_add_(run_alloc_(palloc, sizes[k], now, presult), now + lives[k]);
+	}
+	run_sample_(palloc, now, presult);
+
+	free(sizes);
+	free(lives);
+	free(freed);
+}
+
+/* ---- Programa ---- */
+
+static void run_(const allocator_t* palloc, model_t model, uint64_t horizon_ms, result_t* presult)
+{
+	memset(presult, 0, sizeof(*presult));
+	presult->free_min = UINT32_MAX;
+	presult->largest_min = UINT32_MAX;
+	rng_ = 0x12345678;
+	live_count_ = 0;
+
+	if (!palloc->init())
+	{
+		fprintf(stderr, "%s: no se pudo inicializar\n", palloc->name);
+		return;
+	}
+	switch (model)
+	{
+		case MODEL_FIRMWARE_:
+			run_firmware_(palloc, horizon_ms, presult);
+			break;
+		case MODEL_RANDOM_:
+			run_random_(palloc, horizon_ms, presult);
+			break;
+		case MODEL_TRACE_:
+		default:
+			if (0 == horizon_ms)
+			{
+				run_trace_replay_(palloc, presult);
+			}
+			else
+			{
+				run_trace_long_(palloc, horizon_ms, presult);
+			}
+			break;
+	}
+
+	// Lo que sigue vivo se devuelve (pools de dimensionado usan libc)
+	while (0 < live_count_)
+	{
+		live_release_(palloc, 0, presult);
+	}
+}
+
+/* Cota superior del bucket que contiene al 99% de los malloc */
+static uint32_t ns_p99_(const result_t* presult)
+{
+	uint64_t rank = presult->mallocs - presult->mallocs / 100;
+	uint64_t count = 0;
+	for (uint32_t bucket = 0; bucket < NS_BUCKETS_; bucket++)
+	{
+		count += presult->ns_hist[bucket];
+		if ((0 != count) && (count >= rank))
+		{
+			return (bucket + 1) * NS_BUCKET_;
+		}
+	}
+	return 0;
+}
+
+static void print_(const char* name, const result_t* presult, bool steps)
+{
+	char first[16] = "-";
+	char worst[16] = "O(1)";
+	if (0 != presult->failures)
+	{
+		snprintf(first, sizeof(first), "%.2f", presult->first_failure_h);
+	}
+	if (steps)
+	{
+		snprintf(worst, sizeof(worst), "%llu", (unsigned long long)presult->steps_max);
+	}
+	printf("%-8s %12llu %8llu %10s %8s %9u %8.1f %9u %9u %9u\n", name, (unsigned long long)presult->ops,
+			(unsigned long long)presult->failures, first, worst, ns_p99_(presult),
+			(0 == presult->mallocs) ? 0.0 : (presult->ns_sum / (double)presult->mallocs),
+			presult->free_min, presult->largest_min, presult->largest_end);
+}
+
+static bool parse_regions_(char* list)
+{
+	heap5_count_ = 0;
+	for (char* tok = strtok(list, ","); NULL != tok; tok = strtok(NULL, ","))
+	{
+		uint32_t size = (uint32_t)strtoul(tok, NULL, 0);
+		if ((HEAP5_REGIONS_MAX_ <= heap5_count_) || (size < (4 * HEAP4_MIN_BLOCK_)))
+		{
+			return false;
+		}
+		heap5_regions_[heap5_count_++] = size;
+	}
+
+	uint32_t total = 0;
+	for (uint32_t i = 0; i < heap5_count_; i++)
+	{
+		total += heap5_regions_[i];
+	}
+	return (0 < heap5_count_) && (total <= HEAP_SIZE_);
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+	model_t model = MODEL_FIRMWARE_;
+	double hours = 0;
+	const char* trace_path = NULL;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool ok = (i + 1) < argc;
+		if (ok && (0 == strcmp(argv[i], "--trace")))
+		{
+			trace_path = argv[++i];
+			model = MODEL_TRACE_;
+		}
+		else if (ok && (0 == strcmp(argv[i], "--model")))
+		{
+			i++;
+			model = (0 == strcmp(argv[i], "random")) ? MODEL_RANDOM_ : MODEL_FIRMWARE_;
+			ok = (0 == strcmp(argv[i], "random")) || (0 == strcmp(argv[i], "firmware"));
+		}
+		else if (ok && (0 == strcmp(argv[i], "--hours")))
+		{
+			hours = strtod(argv[++i], NULL);
+		}
+		else if (ok && (0 == strcmp(argv[i], "--heap5-regions")))
+		{
+			ok = parse_regions_(argv[++i]);
+		}
+		else if (ok && (0 == strcmp(argv[i], "--csv")))
+		{
+			csv_ = fopen(argv[++i], "w");
+			ok = (NULL != csv_);
+		}
+		else
+		{
+			ok = false;
+		}
+		if (!ok)
+		{
+			fprintf(stderr, "uso: %s [--model firmware|random | --trace archivo] [--hours h]\n"
+					"          [--heap5-regions b1,b2,...] [--csv archivo]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if ((MODEL_TRACE_ == model) && !trace_load_(trace_path))
+	{
+		fprintf(stderr, "%s: traza vacia o ilegible\n", trace_path);
+		return 1;
+	}
+	if ((MODEL_TRACE_ != model) && (0 >= hours))
+	{
+		hours = 24;
+	}
+	uint64_t horizon_ms = (uint64_t)(hours * 3600000.0);
+
+	if (NULL != csv_)
+	{
+		fprintf(csv_, "horas,asignador,libre,mayor_libre\n");
+	}
+
+	// Pools: primero se mide el pico de cada clase con la misma secuencia
+	result_t result;
+	pool_sizing_ = true;
+	memset(pool_peak_, 0, sizeof(pool_peak_));
+	run_(&allocators_[3], model, horizon_ms, &result);
+	pool_sizing_ = false;
+
+	printf("heap=%u bytes, heap_5 en %u regiones, %s, %.1f h\n", HEAP_SIZE_, heap5_count_,
+			(MODEL_TRACE_ == model) ? trace_path : ((MODEL_RANDOM_ == model) ? "modelo random" : "modelo firmware"), hours);
+	printf("pools:");
+	for (uint32_t cls = 0; cls < POOL_CLASSES_; cls++)
+	{
+		if (0 != pool_peak_[cls])
+		{
+			printf(" %ux%u", pool_peak_[cls], POOL_CLASS_MIN_ << cls);
+		}
+	}
+	printf(" (pico por clase, recortado a %u bytes)\n", HEAP_SIZE_);
+	printf("%-8s %12s %8s %10s %8s %9s %8s %9s %9s %9s\n", "heap", "operaciones", "fallos", "1er fallo h",
+			"pasos", "p99 ns", "ns medio", "libre min", "mayor min", "mayor fin");
+
+	for (uint32_t i = 0; i < (sizeof(allocators_) / sizeof(allocators_[0])); i++)
+	{
+		run_(&allocators_[i], model, horizon_ms, &result);
+		print_(allocators_[i].name, &result, NULL != allocators_[i].steps);
+	}
+
+	if (NULL != csv_)
+	{
+		fclose(csv_);
+	}
+	return 0;
+}
+
+/********************** end of file ******************************************/
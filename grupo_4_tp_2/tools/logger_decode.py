@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# Decodificador del logger binario (LOGGER_CONFIG_USE_BINARY = 1).
+#
+# Toma el ELF del firmware (de donde saca la seccion .logger_fmt y los strings
+# apuntados por argumentos %s) y un stream capturado (archivo de semihosting,
+# dump de la UART o '-' para stdin) y reconstruye las lineas de texto.
+#
+# Uso:
+#   logger_decode.py Debug/grupo_4_tp_2.elf logger.bin [--clock 1000000]
+#
+# Trama (little endian):
+#   [0xA0 | nargs] [id u16] [timestamp u32, us del timebase] [arg u32] * nargs
+#
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA0
+SYNC_MASK = 0xF0
+ID_DROPPED = 0xFFFF
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+SPEC_RE = re.compile(r'%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z|j|t)?([diouxXcsp%])')
+
+
+class Elf32:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1:
+            raise ValueError('%s: no es un ELF32' % path)
+        (shoff,) = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', self.data, 0x2E)
+        raw = []
+        for i in range(shnum):
+            raw.append(struct.unpack_from('<IIIIIIIIII', self.data, shoff + i * shentsize))
+        strtab = raw[shstrndx]
+        self.sections = []
+        for (name, stype, flags, addr, offset, size, _, _, _, _) in raw:
+            start = strtab[4] + name
+            sname = self.data[start:self.data.index(b'\0', start)].decode()
+            self.sections.append((sname, stype, flags, addr, offset, size))
+
+    def section(self, name):
+        for (sname, _, _, _, offset, size) in self.sections:
+            if sname == name:
+                return self.data[offset:offset + size]
+        raise KeyError('seccion %s no encontrada' % name)
+
+    def string_at(self, address):
+        for (_, stype, flags, addr, offset, size) in self.sections:
+            if (flags & SHF_ALLOC) and stype != SHT_NOBITS and addr <= address < addr + size:
+                start = offset + (address - addr)
+                end = self.data.index(b'\0', start)
+                return self.data[start:end].decode(errors='replace')
+        return '<0x%08x>' % address
+
+
+def cstring(blob, offset):
+    end = blob.index(b'\0', offset)
+    return blob[offset:end].decode(errors='replace')
+
+
+def render(fmt, args, elf):
+    values = []
+    it = iter(args)
+    for conv in SPEC_RE.findall(fmt):
+        if conv == '%':
+            continue
+        word = next(it, 0)
+        if conv == 's':
+            values.append(elf.string_at(word))
+        elif conv in 'di':
+            values.append(word - (1 << 32) if word & 0x80000000 else word)
+        elif conv == 'c':
+            values.append(chr(word & 0xFF))
+        elif conv == 'p':
+            values.append('0x%08x' % word)
+        else:
+            values.append(word)
+    fmt = re.sub(r'%p', '%s', fmt)
+    try:
+        return fmt % tuple(values)
+    except (TypeError, ValueError):
+        return '%s %r' % (fmt, args)
+
+
+def frames(stream):
+    buf = b''
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            return
+        buf += chunk
+        i = 0
+        while i < len(buf):
+            head = buf[i]
+            if (head & SYNC_MASK) != SYNC:
+                i += 1  # resincronizar
+                continue
+            nargs = head & 0x0F
+            size = 7 + 4 * nargs
+            if len(buf) - i < size:
+                break
+            rec_id, ts = struct.unpack_from('<HI', buf, i + 1)
+            args = struct.unpack_from('<%dI' % nargs, buf, i + 7)
+            yield rec_id, ts, args
+            i += size
+        buf = buf[i:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decodifica el logger binario')
+    parser.add_argument('elf', help='ELF del firmware')
+    parser.add_argument('stream', help="captura binaria ('-' para stdin)")
+    parser.add_argument('--clock', type=float, default=1e6,
+                        help='frecuencia del timestamp en Hz (timebase, TIM2)')
+    opts = parser.parse_args()
+
+    elf = Elf32(opts.elf)
+    table = elf.section('.logger_fmt')
+    stream = sys.stdin.buffer if opts.stream == '-' else open(opts.stream, 'rb')
+
+    count = 0
+    lost = 0
+    for rec_id, ts, args in frames(stream):
+        t_ms = ts * 1000.0 / opts.clock
+        if rec_id == ID_DROPPED:
+            lost += args[0] if args else 0
+            print('%12.3f ms  <<< %d registros perdidos >>>' % (t_ms, args[0] if args else 0))
+            continue
+        if rec_id >= len(table):
+            print('%12.3f ms  <<< ID desconocido %d >>>' % (t_ms, rec_id))
+            continue
+        print('%12.3f ms  %s' % (t_ms, render(cstring(table, rec_id), args, elf)))
+        count += 1
+
+    print('--- %d registros, %d perdidos' % (count, lost), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+#
+# Chequeo de loopback del transporte UART DMA del logger
+# (LOGGER_CONFIG_USE_UART_DMA = 1).
+#
+# Lee del puerto de la placa (o de una captura), verifica que los registros
+# lleguen ordenados por timestamp y mide el throughput contra la capacidad
+# teorica del enlace. Funciona con el modo texto (requiere
+# LOGGER_CONFIG_USE_TIMESTAMP = 1) y con el modo binario.
+#
+# Uso:
+#   stty -F /dev/ttyACM0 115200 raw -echo
+#   logger_uart_check.py /dev/ttyACM0 --seconds 10 [--binary]
+#
+
+import argparse
+import os
+import re
+import select
+import sys
+import time
+
+from logger_decode import frames, ID_DROPPED
+
+TEXT_TS_RE = re.compile(rb'^\[(\d+)\] ')
+
+
+def read_for(path, seconds):
+    fd = os.open(path, os.O_RDONLY | os.O_NONBLOCK)
+    data = bytearray()
+    start = time.monotonic()
+    first = None
+    try:
+        while time.monotonic() - start < seconds:
+            ready, _, _ = select.select([fd], [], [], 0.1)
+            if not ready:
+                continue
+            chunk = os.read(fd, 4096)
+            if not chunk:
+                break
+            if first is None:
+                first = time.monotonic()
+            data += chunk
+    finally:
+        os.close(fd)
+    elapsed = time.monotonic() - (first if first is not None else start)
+    return bytes(data), max(elapsed, 1e-6)
+
+
+class Chunks:
+    def __init__(self, data):
+        self.data = data
+
+    def read(self, _size):
+        data, self.data = self.data, b''
+        return data
+
+
+def check_binary(data):
+    stamps, lost = [], 0
+    for rec_id, ts, args in frames(Chunks(data)):
+        if rec_id == ID_DROPPED:
+            lost += args[0] if args else 0
+        else:
+            stamps.append(ts)
+    return stamps, lost
+
+
+def check_text(data):
+    stamps = []
+    for line in data.split(b'\n'):
+        m = TEXT_TS_RE.match(line)
+        if m:
+            stamps.append(int(m.group(1)))
+    return stamps, 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Loopback del logger por UART')
+    parser.add_argument('port', help='puerto serie ya configurado o archivo capturado')
+    parser.add_argument('--seconds', type=float, default=10.0)
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--binary', action='store_true', help='stream LOGGER_CONFIG_USE_BINARY')
+    opts = parser.parse_args()
+
+    if os.path.isfile(opts.port):
+        with open(opts.port, 'rb') as f:
+            data = f.read()
+        elapsed = None
+    else:
+        data, elapsed = read_for(opts.port, opts.seconds)
+
+    stamps, lost = check_binary(data) if opts.binary else check_text(data)
+
+    # Timestamps de 32 bits: se toleran los wraps del contador
+    out_of_order = 0
+    for prev, cur in zip(stamps, stamps[1:]):
+        if ((cur - prev) & 0xFFFFFFFF) >= 0x80000000:
+            out_of_order += 1
+
+    print('bytes         : %d' % len(data))
+    print('registros     : %d' % len(stamps))
+    print('perdidos      : %d' % lost)
+    print('fuera de orden: %d' % out_of_order)
+    if elapsed is not None:
+        link = opts.baud / 10.0
+        rate = len(data) / elapsed
+        print('throughput    : %.0f B/s (%.1f %% de %.0f B/s), %.1f registros/s'
+              % (rate, 100.0 * rate / link, link, len(stamps) / elapsed))
+
+    sys.exit(1 if out_of_order or not stamps else 0)
+
+
+if __name__ == '__main__':
+    main()
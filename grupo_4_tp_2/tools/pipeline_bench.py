@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+#
+# Corre los binarios host/build/q<n>/pipeline_bench (uno por largo de cola,
+# ver 'make -C host bench'), junta las lineas JSON de cada tasa y las muestra
+# en una tabla. Con --baseline compara contra una corrida guardada y termina
+# con codigo 1 si el throughput baja o las perdidas, los ciclos o la latencia
+# suben mas que la tolerancia.
+#
+# Uso:
+#   pipeline_bench.py host/build/q5/pipeline_bench host/build/q10/pipeline_bench
+#       [--rates 10,100,1000,10000] [--seconds 2]
+#       [--save-baseline base.json | --baseline base.json [--tolerance 0.5]]
+#
+# Los ciclos del host son tiempo de pared escalado a 84 MHz: una base sirve
+# solo para la misma maquina.
+#
+
+import argparse
+import json
+import subprocess
+import sys
+
+COLUMNS = [
+    ('ui_queue', 'uiq'),
+    ('led_queue', 'ledq'),
+    ('rate', 'rate'),
+    ('events_per_s', 'ev/s'),
+    ('led_events_per_s', 'led/s'),
+    ('ui_send_failed', 'ui_fail'),
+    ('pool_exhausted', 'pool_ex'),
+    ('led_send_failed', 'led_fail'),
+    ('led_pool_exhausted', 'lpool_ex'),
+    ('ui_cycles_mean', 'ui_cyc'),
+    ('led_cycles_mean', 'led_cyc'),
+    ('latency_p99_us', 'p99_us'),
+    ('heap_min', 'heap_min'),
+]
+
+# Metricas que empeoran al subir / al bajar
+WORSE_UP = ['ui_send_failed', 'pool_exhausted', 'led_send_failed', 'led_pool_exhausted',
+            'ui_cycles_mean', 'led_cycles_mean', 'latency_p99_us']
+WORSE_DOWN = ['events_per_s', 'led_events_per_s', 'heap_min']
+
+LOSSES = ['ui_send_failed', 'pool_exhausted', 'led_send_failed', 'led_pool_exhausted']
+
+# Diferencias absolutas por debajo de esto no cuentan (ruido del scheduler del
+# host); las perdidas toleran ademas LOSS_SLACK de los eventos enviados
+SLACK = {'ui_cycles_mean': 500, 'led_cycles_mean': 50, 'latency_p99_us': 100}
+LOSS_SLACK = 0.02
+
+
+def run(binary, rates, seconds):
+    cmd = [binary, '--rates', rates, '--seconds', str(seconds)]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+    return [json.loads(line) for line in out.splitlines() if line.startswith('{')]
+
+
+def key(result):
+    return (result['ui_queue'], result['led_queue'], result['by_value'], result['rate'])
+
+
+def table(results):
+    print(' '.join('%9s' % title for _, title in COLUMNS))
+    for r in results:
+        print(' '.join('%9d' % r[name] for name, _ in COLUMNS))
+
+
+def compare(results, baseline, tolerance):
+    base = {key(r): r for r in baseline}
+    regressions = []
+    for r in results:
+        b = base.get(key(r))
+        if b is None:
+            continue
+        for name in WORSE_UP:
+            slack = r['sent'] * LOSS_SLACK if name in LOSSES else SLACK.get(name, 0)
+            limit = max(b[name] * (1 + tolerance), b[name] + slack)
+            if r[name] > limit:
+                regressions.append((r, name, b[name]))
+        for name in WORSE_DOWN:
+            if r[name] < b[name] * (1 - tolerance):
+                regressions.append((r, name, b[name]))
+    for r, name, was in regressions:
+        print('regresion: q%d/%d rate %d: %s %d -> %d' % (r['ui_queue'], r['led_queue'], r['rate'],
+                                                         name, was, r[name]), file=sys.stderr)
+    return not regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Throughput del pipeline ao_ui -> ao_led en el host')
+    parser.add_argument('binaries', nargs='+', help='binarios pipeline_bench')
+    parser.add_argument('--rates', default='10,100,1000,10000', help='eventos/s separados por coma')
+    parser.add_argument('--seconds', type=int, default=2, help='ventana de medicion por tasa')
+    parser.add_argument('--save-baseline', metavar='ARCHIVO', help='guardar los resultados como base')
+    parser.add_argument('--baseline', metavar='ARCHIVO', help='comparar contra una base guardada')
+    parser.add_argument('--tolerance', type=float, default=0.5, help='tolerancia relativa (0.5 = 50%%)')
+    args = parser.parse_args()
+
+    results = []
+    for binary in args.binaries:
+        results.extend(run(binary, args.rates, args.seconds))
+    table(results)
+
+    if args.save_baseline:
+        with open(args.save_baseline, 'w') as f:
+            json.dump(results, f, indent=1)
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        if not compare(results, baseline, args.tolerance):
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : time_wheel_bench.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Compara en el host la rueda de tiempo de app/src/time_wheel.c con un modelo
+ * de los software timers de FreeRTOS (timers.c): lista ordenada por
+ * vencimiento con insercion lineal (vListInsert) y una cola de comandos de
+ * configTIMER_QUEUE_LENGTH entradas hacia la tarea del daemon.
+ *
+ * Cada tick se procesan los vencimientos (los de un disparo se rearman con un
+ * plazo nuevo, como un timeout de protocolo) y llega una rafaga de rearmes
+ * sobre timers al azar. Ambos modelos ven la misma secuencia: el plazo del
+ * rearme sale del indice del timer y de cuantas veces vencio, no del orden en
+ * que cada modelo procesa los vencimientos del tick, y el generador solo se
+ * usa en la rafaga. Los "vencidos" de los dos coinciden.
+ *
+ * Uso:
+ *   cc -O2 -I app/inc -o time_wheel_bench tools/time_wheel_bench.c app/src/time_wheel.c
+ *   ./time_wheel_bench [ticks] [rafaga]
+ *
+ * "rechazados" son los comandos que no entran en la cola del daemon si la
+ * rafaga llega desde una ISR o una tarea de mayor prioridad que el daemon.
+ * En esta aplicacion el daemon (prioridad 2) le gana a los objetos activos,
+ * asi que cada comando cuesta ademas dos cambios de contexto.
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "time_wheel.h"
+
+/********************** macros and definitions *******************************/
+
+#define TIMER_QUEUE_LENGTH_      (10)       // configTIMER_QUEUE_LENGTH
+#define TIMERS_MAX_              (4000)
+#define DELAY_MAX_               (5000)     // ticks, plazo de los de un disparo
+#define PERIOD_MIN_              (10)
+#define PERIOD_MAX_              (1000)
+#define PERIODIC_RATIO_          (5)        // uno de cada 5 es periodico
+
+/********************** internal data declaration ****************************/
+
+/* Item de lista de FreeRTOS: doblemente enlazado, ordenado por xItemValue */
+typedef struct list_item_s
+{
+	struct list_item_s* next;
+	struct list_item_s* prev;
+	uint64_t value;
+	uint32_t period;
+	bool linked;
+} list_item_t;
+
+typedef struct
+{
+	time_wheel_timer_t timer;   // primer miembro
+	uint32_t index;
+} wheel_item_t;
+
+typedef struct
+{
+	const char* name;
+	double ns_per_tick;
+	double ns_worst;
+	double steps_per_insert;
+	uint64_t expired;
+	uint64_t rejected;
+} result_t;
+
+/********************** internal data definition *****************************/
+
+static uint32_t rng_;
+static uint32_t expiries_[TIMERS_MAX_];  // vencimientos de un disparo por timer
+
+static list_item_t list_end_;       // centinela con el valor maximo
+static list_item_t list_items_[TIMERS_MAX_];
+static uint64_t list_steps_;
+static uint64_t list_inserts_;
+
+static time_wheel_t wheel_;
+static wheel_item_t wheel_items_[TIMERS_MAX_];
+static uint32_t wheel_now_;
+static uint64_t wheel_expired_;
+
+/********************** internal functions definition ************************/
+
+static uint32_t rand_(void)
+{
+	rng_ ^= rng_ << 13;
+	rng_ ^= rng_ >> 17;
+	rng_ ^= rng_ << 5;
+	return rng_;
+}
+
+static uint32_t delay_(void)
+{
+	return 1 + (rand_() % DELAY_MAX_);
+}
+
+/* Plazo del n-esimo armado de un timer de un disparo (hash de indice y n) */
+static uint32_t delay_of_(uint32_t index)
+{
+	uint32_t x = (index * 0x9E3779B1U) ^ ((expiries_[index]++ + 1) * 0x85EBCA77U);
+	x ^= x >> 15;
+	x *= 0x2C1B3C6DU;
+	x ^= x >> 12;
+	x *= 0x297A2D39U;
+	x ^= x >> 15;
+	return 1 + (x % DELAY_MAX_);
+}
+
+static void sequence_reset_(void)
+{
+	rng_ = 0x12345678;
+	for (uint32_t i = 0; i < TIMERS_MAX_; i++)
+	{
+		expiries_[i] = 0;
+	}
+}
+
+static uint32_t period_(uint32_t index)
+{
+	return (0 == (index % PERIODIC_RATIO_)) ? (PERIOD_MIN_ + (index % (PERIOD_MAX_ - PERIOD_MIN_))) : 0;
+}
+
+static double now_ns_(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ---- Modelo de timers.c ---- */
+
+static void list_remove_(list_item_t* item)
+{
+	item->prev->next = item->next;
+	item->next->prev = item->prev;
+	item->linked = false;
+}
+
+/* vListInsert: recorre desde el principio hasta el primer valor mayor */
+static void list_insert_(list_item_t* item, uint64_t value)
+{
+	list_item_t* it = &list_end_;
+
+	if (item->linked)
+	{
+		list_remove_(item);
+	}
+	item->value = value;
+	while (it->next->value <= value)
+	{
+		it = it->next;
+		list_steps_++;
+	}
+	item->next = it->next;
+	item->prev = it;
+	it->next->prev = item;
+	it->next = item;
+	item->linked = true;
+	list_inserts_++;
+}
+
+static void list_run_(uint32_t ntimers, uint32_t ticks, uint32_t burst, result_t* result)
+{
+	list_end_.value = UINT64_MAX;
+	list_end_.next = &list_end_;
+	list_end_.prev = &list_end_;
+	list_steps_ = 0;
+	list_inserts_ = 0;
+	sequence_reset_();
+
+	for (uint32_t i = 0; i < ntimers; i++)
+	{
+		list_items_[i].linked = false;
+		list_items_[i].period = period_(i);
+		list_insert_(&list_items_[i], delay_of_(i));
+	}
+
+	double total = 0;
+	double worst = 0;
+	uint64_t expired = 0;
+	for (uint64_t now = 1; now <= ticks; now++)
+	{
+		double start = now_ns_();
+
+		// prvProcessExpiredTimer: los periodicos se recargan desde el vencimiento
+		while (list_end_.next->value <= now)
+		{
+			list_item_t* item = list_end_.next;
+			list_remove_(item);
+			list_insert_(item, (0 != item->period) ? (item->value + item->period) : (now + delay_of_((uint32_t)(item - list_items_))));
+			expired++;
+		}
+		for (uint32_t i = 0; i < burst; i++)
+		{
+			list_item_t* item = &list_items_[rand_() % ntimers];
+			list_insert_(item, now + ((0 != item->period) ? item->period : delay_()));
+		}
+
+		double elapsed = now_ns_() - start;
+		total += elapsed;
+		worst = (elapsed > worst) ? elapsed : worst;
+	}
+
+	result->name = "freertos";
+	result->ns_per_tick = total / ticks;
+	result->ns_worst = worst;
+	result->steps_per_insert = (double)list_steps_ / (double)list_inserts_;
+	result->expired = expired;
+	result->rejected = (burst > TIMER_QUEUE_LENGTH_) ? ((uint64_t)(burst - TIMER_QUEUE_LENGTH_) * ticks) : 0;
+}
+
+/* ---- Rueda ---- */
+
+static void wheel_on_expired_(time_wheel_timer_t* ptimer)
+{
+	if (0 == ptimer->period)
+	{
+		(void)time_wheel_arm(&wheel_, ptimer, wheel_now_ + delay_of_(((wheel_item_t*)ptimer)->index), 0);
+	}
+	wheel_expired_++;
+}
+
+static void wheel_run_(uint32_t ntimers, uint32_t ticks, uint32_t burst, result_t* result)
+{
+	time_wheel_init(&wheel_, 1);
+	wheel_now_ = 0;
+	wheel_expired_ = 0;
+	sequence_reset_();
+
+	for (uint32_t i = 0; i < ntimers; i++)
+	{
+		wheel_items_[i].index = i;
+		time_wheel_timer_init(&wheel_items_[i].timer, wheel_on_expired_);
+		(void)time_wheel_arm(&wheel_, &wheel_items_[i].timer, delay_of_(i), period_(i));
+	}
+
+	double total = 0;
+	double worst = 0;
+	for (uint32_t now = 1; now <= ticks; now++)
+	{
+		double start = now_ns_();
+
+		wheel_now_ = now;
+		(void)time_wheel_advance(&wheel_, now);
+		for (uint32_t i = 0; i < burst; i++)
+		{
+			wheel_item_t* item = &wheel_items_[rand_() % ntimers];
+			uint32_t period = period_(item->index);
+			(void)time_wheel_arm(&wheel_, &item->timer, now + ((0 != period) ? period : delay_()), period);
+		}
+
+		double elapsed = now_ns_() - start;
+		total += elapsed;
+		worst = (elapsed > worst) ? elapsed : worst;
+	}
+
+	result->name = "rueda";
+	result->ns_per_tick = total / ticks;
+	result->ns_worst = worst;
+	result->steps_per_insert = 0;
+	result->expired = wheel_expired_;
+	result->rejected = 0;
+}
+
+static void print_(uint32_t ntimers, const result_t* result)
+{
+	printf("%7u  %-9s %10.1f %12.0f %12.1f %10llu %11llu\n", ntimers, result->name,
+			result->ns_per_tick, result->ns_worst, result->steps_per_insert,
+			(unsigned long long)result->expired, (unsigned long long)result->rejected);
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+	static const uint32_t ntimers[] = {10, 100, 500, 1000, 4000};
+	uint32_t ticks = (1 < argc) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100000;
+	uint32_t burst = (2 < argc) ? (uint32_t)strtoul(argv[2], NULL, 0) : 4;
+
+	printf("ticks=%u rafaga=%u cola del daemon=%u\n", ticks, burst, TIMER_QUEUE_LENGTH_);
+	printf("%7s  %-9s %10s %12s %12s %10s %11s\n", "timers", "modelo", "ns/tick", "peor tick ns",
+			"pasos/ins", "vencidos", "rechazados");
+
+	for (uint32_t i = 0; i < (sizeof(ntimers) / sizeof(ntimers[0])); i++)
+	{
+		result_t result;
+
+		list_run_(ntimers[i], ticks, burst, &result);
+		print_(ntimers[i], &result);
+		wheel_run_(ntimers[i], ticks, burst, &result);
+		print_(ntimers[i], &result);
+	}
+	return 0;
+}
+
+/********************** end of file ******************************************/
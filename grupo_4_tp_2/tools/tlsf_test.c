@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024 Sebastian Bedin <sebabedin@gmail.com>.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @file   : tlsf_test.c
+ * @author : Grupo 4 (Arce, Folmer, Kirschner)
+ * @version	v1.0.0
+ */
+
+/*
+ * Pruebas de app/src/tlsf.c en el host (el repo no tiene framework de
+ * pruebas: sale con 0 si todo pasa y con 1 al primer error).
+ *
+ * - API: malloc(0), pedidos mayores al heap, free(NULL), alineacion, doble
+ *   free detectado por tlsf_is_allocated, contadores de tlsf_get_stats y el
+ *   contrato de largest_alloc (atendible; un ALIGN mas, no)
+ * - Estres: malloc/free al azar con tlsf_check despues de cada operacion y
+ *   un patron por bloque que detecta solapamientos
+ * - Tiempo: pasos (TLSF_STEP, operaciones sobre listas y bitmaps) por
+ *   malloc y free; el mismo tope con el heap recien armado y con el heap
+ *   fragmentado por el estres
+ *
+ * Uso:
+ *   cc -O2 -Wall -I app/inc -o tlsf_test tools/tlsf_test.c
+ *   ./tlsf_test [operaciones] [semilla]
+ *
+ * Incluye tlsf.c para contar sus pasos; no se enlaza con app/src/tlsf.c.
+ */
+
+/********************** inclusions *******************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t steps_;
+#define TLSF_STEP()              (steps_++)
+
+#include "../app/src/tlsf.c"
+
+/********************** macros and definitions *******************************/
+
+#define HEAP_SIZE_               (15360)    // configTOTAL_HEAP_SIZE
+#define SLOTS_                   (64)
+#define SIZE_MAX_REQ_            (768)
+#define OPS_DEFAULT_             (200000)
+
+// Peor caso por construccion (ver tlsf_malloc/tlsf_free)
+#define MALLOC_STEPS_MAX_        (4)        // busqueda, cabeza de clase, quitar, resto
+#define FREE_STEPS_MAX_          (5)        // dos uniones (quitar y absorber) e insertar
+
+#define CHECK_(cond, ...)                                                   \
+	do                                                                      \
+	{                                                                       \
+		if (!(cond))                                                        \
+		{                                                                   \
+			fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);                 \
+			fprintf(stderr, __VA_ARGS__);                                   \
+			fprintf(stderr, "\n");                                          \
+			exit(1);                                                        \
+		}                                                                   \
+	} while (0)
+
+/********************** internal data declaration ****************************/
+
+typedef struct
+{
+	uint8_t* ptr;
+	size_t size;
+	uint8_t fill;
+} slot_t;
+
+typedef struct
+{
+	uint32_t malloc_max;
+	uint32_t free_max;
+} steps_t;
+
+/********************** internal data definition *****************************/
+
+static uint8_t heap_[HEAP_SIZE_] __attribute__((aligned(TLSF_ALIGN)));
+static tlsf_t tlsf_;
+static slot_t slots_[SLOTS_];
+static uint32_t rng_;
+
+/********************** internal functions definition ************************/
+
+static uint32_t rand_(void)
+{
+	rng_ ^= rng_ << 13;
+	rng_ ^= rng_ >> 17;
+	rng_ ^= rng_ << 5;
+	return rng_;
+}
+
+static void* malloc_(size_t size, steps_t* psteps)
+{
+	steps_ = 0;
+	void* ptr = tlsf_malloc(&tlsf_, size);
+	if (steps_ > psteps->malloc_max)
+	{
+		psteps->malloc_max = steps_;
+	}
+	return ptr;
+}
+
+static void free_(void* ptr, steps_t* psteps)
+{
+	steps_ = 0;
+	tlsf_free(&tlsf_, ptr);
+	if (steps_ > psteps->free_max)
+	{
+		psteps->free_max = steps_;
+	}
+}
+
+/* Toda la memoria del bloque inicial es datos o cabeceras: lo ocupado mas lo
+ * libre mas una cabecera por bloque (menos la del inicial) suman size */
+static void check_stats_(uint32_t live, size_t used, uint32_t allocs, uint32_t frees)
+{
+	tlsf_stats_t stats;
+	tlsf_get_stats(&tlsf_, &stats);
+
+	CHECK_(tlsf_check(&tlsf_), "tlsf_check");
+	CHECK_(stats.allocs == allocs, "allocs %u != %u", stats.allocs, allocs);
+	CHECK_(stats.frees == frees, "frees %u != %u", stats.frees, frees);
+	CHECK_(stats.allocs - stats.frees == live, "vivos %u != %u", stats.allocs - stats.frees, live);
+	CHECK_(stats.free + used + (live + stats.free_blocks - 1) * HEADER_SIZE_ == stats.size,
+		   "libre %zu + ocupado %zu + cabeceras != %zu", stats.free, used, stats.size);
+	CHECK_(stats.free_min <= stats.free, "free_min %zu > free %zu", stats.free_min, stats.free);
+	CHECK_(stats.largest_alloc <= stats.largest_free, "largest_alloc > largest_free");
+	CHECK_((0 == stats.free_blocks) || (stats.smallest_free <= stats.largest_free), "smallest > largest");
+	CHECK_((0 != stats.free_blocks) == (0 != stats.free), "free_blocks y free no coinciden");
+}
+
+/* largest_alloc es el mayor pedido atendible: ese tamano entra y uno mas no */
+static void check_largest_(steps_t* psteps)
+{
+	tlsf_stats_t stats;
+	tlsf_get_stats(&tlsf_, &stats);
+	if (0 == stats.largest_alloc)
+	{
+		return;
+	}
+
+	uint32_t failed = tlsf_.failed;
+	void* ptr = malloc_(stats.largest_alloc, psteps);
+	CHECK_(NULL != ptr, "largest_alloc=%zu no se atendio", stats.largest_alloc);
+	free_(ptr, psteps);
+	ptr = malloc_(stats.largest_alloc + TLSF_ALIGN, psteps);
+	CHECK_(NULL == ptr, "largest_alloc=%zu + %lu se atendio", stats.largest_alloc, TLSF_ALIGN);
+
+	// Las sondas no cuentan para el llamador
+	tlsf_.allocs--;
+	tlsf_.frees--;
+	tlsf_.failed = failed;
+}
+
+static void test_api_(void)
+{
+	tlsf_stats_t stats;
+	steps_t steps = {0};
+
+	CHECK_(!tlsf_init(&tlsf_, heap_, 4), "tlsf_init con 4 bytes");
+	CHECK_(NULL == tlsf_malloc(&tlsf_, 8), "malloc sin heap");
+	CHECK_(tlsf_init(&tlsf_, heap_ + 1, HEAP_SIZE_ - 1), "tlsf_init desalineado");
+	CHECK_(tlsf_check(&tlsf_), "tlsf_check desalineado");
+	CHECK_(tlsf_init(&tlsf_, heap_, HEAP_SIZE_), "tlsf_init");
+
+	tlsf_get_stats(&tlsf_, &stats);
+	CHECK_(stats.size == HEAP_SIZE_ - 2 * HEADER_SIZE_, "size %zu", stats.size);
+	CHECK_((stats.free == stats.size) && (stats.free_min == stats.size), "free inicial");
+	CHECK_((stats.largest_free == stats.size) && (stats.largest_alloc == stats.size), "mayor inicial");
+	CHECK_((1 == stats.free_blocks) && (0 == stats.allocs) && (0 == stats.frees), "contadores iniciales");
+
+	// Como heap_4: malloc(0) y pedidos imposibles devuelven NULL
+	CHECK_(NULL == malloc_(0, &steps), "malloc(0)");
+	CHECK_(NULL == malloc_(stats.size + 1, &steps), "malloc(size + 1)");
+	CHECK_(NULL == malloc_(SIZE_MAX, &steps), "malloc(SIZE_MAX)");
+	CHECK_(NULL == malloc_((size_t)1 << TLSF_CONFIG_FL_MAX, &steps), "malloc(BLOCK_MAX)");
+	tlsf_get_stats(&tlsf_, &stats);
+	CHECK_((4 == stats.failed) && (0 == stats.allocs) && (stats.free == stats.size), "fallos %u", stats.failed);
+
+	// free(NULL) no hace nada
+	free_(NULL, &steps);
+	tlsf_get_stats(&tlsf_, &stats);
+	CHECK_((0 == stats.frees) && (stats.free == stats.size), "free(NULL)");
+
+	// Todo el heap en un pedido, y vuelve entero
+	uint8_t* pall = malloc_(stats.size, &steps);
+	CHECK_(NULL != pall, "malloc(size)");
+	free_(pall, &steps);
+
+	// Alineacion y tamano minimo para cada pedido chico
+	for (size_t size = 1; size <= 256; size++)
+	{
+		uint8_t* ptr = malloc_(size, &steps);
+		CHECK_(NULL != ptr, "malloc(%zu)", size);
+		CHECK_(0 == ((uintptr_t)ptr & (TLSF_ALIGN - 1)), "malloc(%zu) desalineado", size);
+		CHECK_(tlsf_block_size(ptr) >= size, "bloque de %zu para %zu", tlsf_block_size(ptr), size);
+		CHECK_(tlsf_is_allocated(&tlsf_, ptr), "malloc(%zu) no figura ocupado", size);
+		memset(ptr, 0xA5, size);
+		free_(ptr, &steps);
+		CHECK_(!tlsf_is_allocated(&tlsf_, ptr), "free(%zu) sigue ocupado", size);
+	}
+
+	// Doble free y punteros ajenos: vPortFree los rechaza con tlsf_is_allocated
+	uint8_t* pa = malloc_(40, &steps);
+	uint8_t* pb = malloc_(40, &steps);
+	CHECK_(!tlsf_is_allocated(&tlsf_, pa + TLSF_ALIGN), "puntero interior");
+	CHECK_(!tlsf_is_allocated(&tlsf_, &stats), "puntero fuera del heap");
+	CHECK_(!tlsf_is_allocated(&tlsf_, pa + 1), "puntero desalineado");
+	free_(pa, &steps);
+	CHECK_(!tlsf_is_allocated(&tlsf_, pa), "doble free");
+	CHECK_(tlsf_is_allocated(&tlsf_, pb), "vecino de un bloque libre");
+	free_(pb, &steps);
+
+	tlsf_get_stats(&tlsf_, &stats);
+	CHECK_((stats.free == stats.size) && (1 == stats.free_blocks), "el heap no volvio entero");
+	CHECK_(stats.allocs == stats.frees, "allocs %u frees %u", stats.allocs, stats.frees);
+	CHECK_(stats.free_min < stats.size, "free_min no bajo");
+	printf("api: ok\n");
+}
+
+/* Heap sin fragmentar: un solo bloque libre que se parte y se vuelve a unir.
+ * Es la referencia para los pasos del estres, que deja huecos de todas las
+ * clases; el tope tiene que ser el mismo */
+static void test_steps_(steps_t* psteps)
+{
+	(void)tlsf_init(&tlsf_, heap_, HEAP_SIZE_);
+	for (uint32_t i = 0; i < 1000; i++)
+	{
+		void* ptr = malloc_(1 + (rand_() % SIZE_MAX_REQ_), psteps);
+		CHECK_(NULL != ptr, "malloc en el heap vacio");
+		free_(ptr, psteps);
+	}
+	CHECK_(tlsf_check(&tlsf_), "tlsf_check");
+}
+
+static void test_stress_(uint32_t ops, steps_t* psteps)
+{
+	uint32_t live = 0;
+	size_t used = 0;
+	uint32_t allocs = 0;
+	uint32_t frees = 0;
+	uint32_t failed = 0;
+
+	(void)tlsf_init(&tlsf_, heap_, HEAP_SIZE_);
+	memset(slots_, 0, sizeof(slots_));
+
+	for (uint32_t op = 0; op < ops; op++)
+	{
+		slot_t* pslot = &slots_[rand_() % SLOTS_];
+		if (NULL == pslot->ptr)
+		{
+			size_t size = 1 + (rand_() % SIZE_MAX_REQ_);
+			pslot->ptr = malloc_(size, psteps);
+			if (NULL == pslot->ptr)
+			{
+				failed++;
+				continue;
+			}
+			CHECK_(0 == ((uintptr_t)pslot->ptr & (TLSF_ALIGN - 1)), "desalineado");
+			pslot->size = size;
+			pslot->fill = (uint8_t)rand_();
+			memset(pslot->ptr, pslot->fill, size);
+			live++;
+			used += tlsf_block_size(pslot->ptr);
+			allocs++;
+		}
+		else
+		{
+			for (size_t i = 0; i < pslot->size; i++)
+			{
+				CHECK_(pslot->ptr[i] == pslot->fill, "bloque pisado en la operacion %u", op);
+			}
+			used -= tlsf_block_size(pslot->ptr);
+			free_(pslot->ptr, psteps);
+			pslot->ptr = NULL;
+			live--;
+			frees++;
+		}
+
+		check_stats_(live, used, allocs, frees);
+		if (0 == (op % 64))
+		{
+			check_largest_(psteps);
+		}
+	}
+
+	CHECK_(tlsf_.failed == failed, "failed %u != %u", tlsf_.failed, failed);
+	printf("estres: %u operaciones, %u fallos por falta de memoria: ok\n", ops, failed);
+}
+
+/********************** external functions definition ************************/
+
+int main(int argc, char* argv[])
+{
+	uint32_t ops = (1 < argc) ? (uint32_t)strtoul(argv[1], NULL, 0) : OPS_DEFAULT_;
+	rng_ = (2 < argc) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x2545F491;
+	if (0 == rng_)
+	{
+		rng_ = 1;
+	}
+
+	steps_t fresh = {0};
+	steps_t frag = {0};
+
+	test_api_();
+	test_steps_(&fresh);
+	test_stress_(ops, &frag);
+
+	printf("pasos: malloc max %u (sin fragmentar %u), free max %u (sin fragmentar %u)\n",
+		   frag.malloc_max, fresh.malloc_max, frag.free_max, fresh.free_max);
+	CHECK_(frag.malloc_max <= MALLOC_STEPS_MAX_, "malloc hizo %u pasos", frag.malloc_max);
+	CHECK_(frag.free_max <= FREE_STEPS_MAX_, "free hizo %u pasos", frag.free_max);
+	return 0;
+}
+
+/********************** end of file ******************************************/
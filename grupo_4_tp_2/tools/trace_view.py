@@ -0,0 +1,266 @@
+#!/usr/bin/env python3
+#
+# Visor del registro de eventos del kernel (TRACE_CONFIG_ENABLE = 1).
+#
+# Lee la imagen trace_dump_t capturada por la UART (trace_dump()) o leida con
+# el debugger:
+#   (gdb) dump binary memory trace.bin &trace_dump_buffer (&trace_dump_buffer)+1
+# y muestra una linea de tiempo por tarea y estadisticas de latencia.
+#
+# Uso:
+#   trace_view.py trace.bin [--width 100] [--chrome trace.json]
+#
+# --chrome genera un JSON de Trace Event Format para chrome://tracing o
+# ui.perfetto.dev.
+#
+# --heap-trace exporta los MALLOC/FREE (TRACE_CONFIG_TRACE_MALLOC) como traza
+# de tools/heap_bench.c: "<us> m <direccion> <bytes pedidos>" y "<us> f <direccion>".
+#
+
+import argparse
+import json
+import struct
+import sys
+from collections import defaultdict, deque
+
+MAGIC = 0x31435254
+HEADER = struct.Struct('<IHHIIII')
+RECORD = struct.Struct('<IBBHI')
+NAME_LEN = 16
+MAX_TASKS = 16
+
+EVENTS = [
+    'NONE', 'SWITCH_IN', 'SWITCH_OUT', 'TASK_CREATE', 'TASK_DELETE',
+    'QUEUE_CREATE', 'QUEUE_DELETE', 'QUEUE_SEND', 'QUEUE_SEND_FAILED',
+    'QUEUE_SEND_FROM_ISR', 'QUEUE_RECEIVE', 'QUEUE_RECEIVE_FAILED',
+    'QUEUE_RECEIVE_FROM_ISR', 'QUEUE_BLOCK_SEND', 'QUEUE_BLOCK_RECEIVE',
+    'MALLOC', 'FREE', 'ISR_ENTER', 'ISR_EXIT', 'USER',
+]
+EV = {name: i for i, name in enumerate(EVENTS)}
+
+HEAP4_HEADER = 8  # traceMALLOC registra el pedido mas la cabecera, alineado
+
+IRQ_NAMES = {17: 'DMA1_Stream6', 38: 'USART2', 40: 'EXTI15_10'}
+
+
+class Trace:
+    def __init__(self, data):
+        start = data.find(struct.pack('<I', MAGIC))
+        if start < 0:
+            raise ValueError('no se encontro la imagen del trace (magic)')
+        (_, version, record_size, capacity, head, clock_hz, overhead) = HEADER.unpack_from(data, start)
+        if record_size != RECORD.size:
+            raise ValueError('tamano de registro %d no soportado' % record_size)
+        self.version = version
+        self.capacity = capacity
+        self.head = head
+        self.clock_hz = clock_hz or 84000000
+        self.overhead = overhead
+        offset = start + HEADER.size
+        # Version 2: numero de tarea duenio de cada ranura de nombre
+        self.owners = [None] * MAX_TASKS
+        if version >= 2:
+            self.owners = list(struct.unpack_from('<%dI' % MAX_TASKS, data, offset))
+            offset += 4 * MAX_TASKS
+        self.names = []
+        for i in range(MAX_TASKS):
+            raw = data[offset + i * NAME_LEN:offset + (i + 1) * NAME_LEN]
+            self.names.append(raw.split(b'\0', 1)[0].decode(errors='replace'))
+        offset += MAX_TASKS * NAME_LEN
+        if len(data) < offset + capacity * RECORD.size:
+            raise ValueError('imagen incompleta')
+
+        count = min(head, capacity)
+        first = head - count
+        records = []
+        for n in range(first, head):
+            records.append(RECORD.unpack_from(data, offset + (n % capacity) * RECORD.size))
+        self.lost = first
+
+        # Timestamps de 32 bits -> monotonicos
+        self.records = []
+        base, prev = 0, None
+        for (ts, event, task, aux, arg) in records:
+            if prev is not None and ts < prev:
+                base += 1 << 32
+            prev = ts
+            self.records.append((base + ts, event, task, aux, arg))
+
+    def us(self, cycles):
+        return cycles * 1e6 / self.clock_hz
+
+    def task_name(self, number):
+        # Una tarea creada despues pudo pisar la ranura (los registros guardan
+        # el numero en 8 bits)
+        slot = number % MAX_TASKS
+        owner = self.owners[slot]
+        name = self.names[slot]
+        if owner is not None and (owner & 0xFF) != (number & 0xFF):
+            name = ''
+        return name if name else 'task#%d' % number
+
+
+def summary(values):
+    if not values:
+        return 'n=0'
+    return 'n=%d min=%.1f mean=%.1f max=%.1f us' % (
+        len(values), min(values), sum(values) / len(values), max(values))
+
+
+def slices(trace):
+    """Intervalos (tarea, inicio, fin) en ejecucion y (irq, inicio, fin)."""
+    runs, isrs = [], []
+    current, since = None, None
+    isr_open = {}
+    for (ts, event, task, aux, arg) in trace.records:
+        if event == EV['SWITCH_IN']:
+            if current is not None:
+                runs.append((current, since, ts))
+            current, since = arg, ts
+        elif event == EV['SWITCH_OUT'] and current == arg:
+            runs.append((current, since, ts))
+            current = None
+        elif event == EV['ISR_ENTER']:
+            isr_open[aux] = ts
+        elif event == EV['ISR_EXIT'] and aux in isr_open:
+            isrs.append((aux, isr_open.pop(aux), ts))
+    if current is not None and trace.records:
+        runs.append((current, since, trace.records[-1][0]))
+    return runs, isrs
+
+
+def timeline(trace, runs, isrs, width):
+    t0, t1 = trace.records[0][0], trace.records[-1][0]
+    span = max(t1 - t0, 1)
+    rows = defaultdict(lambda: [' '] * width)
+    for (task, start, end) in runs:
+        a = int((start - t0) * width / span)
+        b = max(int((end - t0) * width / span), a + 1)
+        for col in range(a, min(b, width)):
+            rows[trace.task_name(task)][col] = '#'
+    for (irq, start, end) in isrs:
+        col = min(int((start - t0) * width / span), width - 1)
+        rows['IRQ ' + IRQ_NAMES.get(irq, str(irq))][col] = '|'
+    for (ts, event, task, aux, arg) in trace.records:
+        if event in (EV['TASK_CREATE'], EV['TASK_DELETE']):
+            col = min(int((ts - t0) * width / span), width - 1)
+            rows[trace.task_name(arg)][col] = '+' if event == EV['TASK_CREATE'] else 'x'
+
+    label = max(len(name) for name in rows) if rows else 4
+    print('%s  %.3f ms .. %.3f ms (%.1f us/col)' % (' ' * label, trace.us(t0) / 1000,
+                                                   trace.us(t1) / 1000, trace.us(span) / width))
+    for name in sorted(rows):
+        print('%-*s |%s|' % (label, name, ''.join(rows[name])))
+
+
+def statistics(trace, runs, isrs):
+    total = max(trace.records[-1][0] - trace.records[0][0], 1)
+    print('\nregistros: %d (perdidos %d), costo por registro: %d ciclos (%.2f us)' % (
+        len(trace.records), trace.lost, trace.overhead, trace.us(trace.overhead)))
+
+    print('\ntareas:')
+    per_task = defaultdict(list)
+    for (task, start, end) in runs:
+        per_task[task].append(end - start)
+    for task in sorted(per_task, key=lambda t: -sum(per_task[t])):
+        durations = per_task[task]
+        print('  %-16s cpu=%5.1f%%  slices %s' % (
+            trace.task_name(task), 100.0 * sum(durations) / total,
+            summary([trace.us(d) for d in durations])))
+
+    print('\ninterrupciones:')
+    per_irq = defaultdict(list)
+    for (irq, start, end) in isrs:
+        per_irq[irq].append(trace.us(end - start))
+    for irq in sorted(per_irq):
+        print('  %-16s duracion %s' % (IRQ_NAMES.get(irq, str(irq)), summary(per_irq[irq])))
+
+    # ISR -> primera conmutacion posterior (latencia de despacho)
+    wake = []
+    pending = None
+    for (ts, event, task, aux, arg) in trace.records:
+        if event == EV['ISR_EXIT']:
+            pending = ts
+        elif event == EV['SWITCH_IN'] and pending is not None:
+            wake.append(trace.us(ts - pending))
+            pending = None
+    print('  ISR exit -> switch in: %s' % summary(wake))
+
+    # Cola: envio -> recepcion (FIFO por direccion de cola)
+    print('\ncolas (envio -> recepcion):')
+    sent = defaultdict(deque)
+    latency = defaultdict(list)
+    blocks = defaultdict(int)
+    for (ts, event, task, aux, arg) in trace.records:
+        if event in (EV['QUEUE_SEND'], EV['QUEUE_SEND_FROM_ISR']):
+            sent[arg].append(ts)
+        elif event in (EV['QUEUE_RECEIVE'], EV['QUEUE_RECEIVE_FROM_ISR']) and sent[arg]:
+            latency[arg].append(trace.us(ts - sent[arg].popleft()))
+        elif event in (EV['QUEUE_BLOCK_SEND'], EV['QUEUE_BLOCK_RECEIVE']):
+            blocks[arg] += 1
+    for queue in sorted(set(latency) | set(blocks)):
+        print('  0x%08x  bloqueos=%d  %s' % (queue, blocks[queue], summary(latency[queue])))
+
+    allocs = sum(1 for r in trace.records if r[1] == EV['MALLOC'])
+    frees = sum(1 for r in trace.records if r[1] == EV['FREE'])
+    print('\nheap: malloc=%d free=%d' % (allocs, frees))
+
+
+def chrome(trace, runs, isrs, path):
+    events = []
+    for (task, start, end) in runs:
+        events.append({'name': trace.task_name(task), 'ph': 'X', 'pid': 0, 'tid': trace.task_name(task),
+                       'ts': trace.us(start), 'dur': trace.us(end - start)})
+    for (irq, start, end) in isrs:
+        name = IRQ_NAMES.get(irq, str(irq))
+        events.append({'name': name, 'ph': 'X', 'pid': 0, 'tid': 'IRQ',
+                       'ts': trace.us(start), 'dur': trace.us(end - start)})
+    for (ts, event, task, aux, arg) in trace.records:
+        if event in (EV['SWITCH_IN'], EV['SWITCH_OUT'], EV['ISR_ENTER'], EV['ISR_EXIT']):
+            continue
+        events.append({'name': EVENTS[event] if event < len(EVENTS) else str(event), 'ph': 'i', 's': 't',
+                       'pid': 0, 'tid': trace.task_name(task), 'ts': trace.us(ts),
+                       'args': {'aux': aux, 'arg': '0x%08x' % arg}})
+    with open(path, 'w') as f:
+        json.dump({'traceEvents': events}, f)
+
+
+def heap_trace(trace, path):
+    count = 0
+    with open(path, 'w') as f:
+        f.write('# us op direccion bytes\n')
+        for (ts, event, task, aux, arg) in trace.records:
+            if event == EV['MALLOC'] and arg != 0:
+                f.write('%d m %x %d\n' % (trace.us(ts), arg, max(aux - HEAP4_HEADER, 1)))
+                count += 1
+            elif event == EV['FREE']:
+                f.write('%d f %x\n' % (trace.us(ts), arg))
+                count += 1
+    print('heap: %d operaciones en %s' % (count, path), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Visor del trace del kernel')
+    parser.add_argument('dump', help="imagen trace_dump_t ('-' para stdin)")
+    parser.add_argument('--width', type=int, default=100)
+    parser.add_argument('--chrome', help='exporta Trace Event Format JSON')
+    parser.add_argument('--heap-trace', help='exporta malloc/free para tools/heap_bench.c')
+    opts = parser.parse_args()
+
+    data = sys.stdin.buffer.read() if opts.dump == '-' else open(opts.dump, 'rb').read()
+    trace = Trace(data)
+    if not trace.records:
+        print('trace vacio')
+        return
+
+    runs, isrs = slices(trace)
+    timeline(trace, runs, isrs, opts.width)
+    statistics(trace, runs, isrs)
+    if opts.chrome:
+        chrome(trace, runs, isrs, opts.chrome)
+    if opts.heap_trace:
+        heap_trace(trace, opts.heap_trace)
+
+
+if __name__ == '__main__':
+    main()